@@ -102,193 +102,329 @@ using to_get_32 = std::tuple<T13, T7, T23, T0, T9, T11, T22, T29, T19, T31, T4,
 BENCHMARK_CAPTURE(vecany_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(hc_1by1_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(ha_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(has_1by1_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hss_1by1_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(hc_bulk_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(ha_bulk_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(has_bulk_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hss_bulk_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,1, to_insert_1{},to_get_1{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,1, to_insert_1{},to_get_1{});
 BENCHMARK_CAPTURE(vecany_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(hc_1by1_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(ha_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(has_1by1_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hss_1by1_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(hc_bulk_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(ha_bulk_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(has_bulk_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hss_bulk_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,2, to_insert_2{},to_get_2{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,2, to_insert_2{},to_get_2{});
 BENCHMARK_CAPTURE(vecany_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(hc_1by1_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(ha_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(has_1by1_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hss_1by1_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(hc_bulk_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(ha_bulk_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(has_bulk_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hss_bulk_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,3, to_insert_3{},to_get_3{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,3, to_insert_3{},to_get_3{});
 BENCHMARK_CAPTURE(vecany_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(hc_1by1_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(ha_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(has_1by1_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hss_1by1_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(hc_bulk_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(ha_bulk_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(has_bulk_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hss_bulk_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,4, to_insert_4{},to_get_4{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,4, to_insert_4{},to_get_4{});
 BENCHMARK_CAPTURE(vecany_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(hc_1by1_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(ha_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(has_1by1_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hss_1by1_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(hc_bulk_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(ha_bulk_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(has_bulk_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hss_bulk_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,5, to_insert_5{},to_get_5{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,5, to_insert_5{},to_get_5{});
 BENCHMARK_CAPTURE(vecany_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(hc_1by1_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(ha_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(has_1by1_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hss_1by1_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(hc_bulk_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(ha_bulk_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(has_bulk_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hss_bulk_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,6, to_insert_6{},to_get_6{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,6, to_insert_6{},to_get_6{});
 BENCHMARK_CAPTURE(vecany_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(hc_1by1_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(ha_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(has_1by1_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hss_1by1_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(hc_bulk_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(ha_bulk_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(has_bulk_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hss_bulk_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,7, to_insert_7{},to_get_7{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,7, to_insert_7{},to_get_7{});
 BENCHMARK_CAPTURE(vecany_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(mapany_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(hc_1by1_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hcp_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(ha_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(hcs_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(has_1by1_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hss_1by1_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hsl_1by1_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hcc_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(entt_ctx_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(andyg_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(entt_reg_1by1_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(vecany_bulk_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(mapany_bulk_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(hc_bulk_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(ha_bulk_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(hcs_bulk_insert,8, to_insert_8{},to_get_8{});
 BENCHMARK_CAPTURE(has_bulk_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hss_bulk_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,8, to_insert_8{},to_get_8{});
+BENCHMARK_CAPTURE(vecany_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(mapany_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(hc_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(hcp_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(ha_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(hcs_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(has_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(hss_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(hsl_bulk_insert,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(hcc_bulk_insert,32, to_insert_32{},to_get_32{});
 BENCHMARK_CAPTURE(vecany_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(mapany_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(hc_get,1, to_insert_32{},to_get_1{});
+BENCHMARK_CAPTURE(hcp_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(ha_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(hcs_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(has_get,1, to_insert_32{},to_get_1{});
+BENCHMARK_CAPTURE(hss_get,1, to_insert_32{},to_get_1{});
+BENCHMARK_CAPTURE(hsl_get,1, to_insert_32{},to_get_1{});
+BENCHMARK_CAPTURE(hcc_get,1, to_insert_32{},to_get_1{});
+BENCHMARK_CAPTURE(hcf_get,1, to_insert_32{},to_get_1{});
+BENCHMARK_CAPTURE(haf_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(entt_ctx_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(andyg_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(entt_reg_get,1, to_insert_32{},to_get_1{});
 BENCHMARK_CAPTURE(vecany_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(mapany_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(hc_get,2, to_insert_32{},to_get_2{});
+BENCHMARK_CAPTURE(hcp_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(ha_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(hcs_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(has_get,2, to_insert_32{},to_get_2{});
+BENCHMARK_CAPTURE(hss_get,2, to_insert_32{},to_get_2{});
+BENCHMARK_CAPTURE(hsl_get,2, to_insert_32{},to_get_2{});
+BENCHMARK_CAPTURE(hcc_get,2, to_insert_32{},to_get_2{});
+BENCHMARK_CAPTURE(hcf_get,2, to_insert_32{},to_get_2{});
+BENCHMARK_CAPTURE(haf_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(entt_ctx_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(andyg_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(entt_reg_get,2, to_insert_32{},to_get_2{});
 BENCHMARK_CAPTURE(vecany_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(mapany_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(hc_get,3, to_insert_32{},to_get_3{});
+BENCHMARK_CAPTURE(hcp_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(ha_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(hcs_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(has_get,3, to_insert_32{},to_get_3{});
+BENCHMARK_CAPTURE(hss_get,3, to_insert_32{},to_get_3{});
+BENCHMARK_CAPTURE(hsl_get,3, to_insert_32{},to_get_3{});
+BENCHMARK_CAPTURE(hcc_get,3, to_insert_32{},to_get_3{});
+BENCHMARK_CAPTURE(hcf_get,3, to_insert_32{},to_get_3{});
+BENCHMARK_CAPTURE(haf_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(entt_ctx_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(andyg_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(entt_reg_get,3, to_insert_32{},to_get_3{});
 BENCHMARK_CAPTURE(vecany_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(mapany_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(hc_get,4, to_insert_32{},to_get_4{});
+BENCHMARK_CAPTURE(hcp_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(ha_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(hcs_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(has_get,4, to_insert_32{},to_get_4{});
+BENCHMARK_CAPTURE(hss_get,4, to_insert_32{},to_get_4{});
+BENCHMARK_CAPTURE(hsl_get,4, to_insert_32{},to_get_4{});
+BENCHMARK_CAPTURE(hcc_get,4, to_insert_32{},to_get_4{});
+BENCHMARK_CAPTURE(hcf_get,4, to_insert_32{},to_get_4{});
+BENCHMARK_CAPTURE(haf_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(entt_ctx_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(andyg_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(entt_reg_get,4, to_insert_32{},to_get_4{});
 BENCHMARK_CAPTURE(vecany_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(mapany_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(hc_get,5, to_insert_32{},to_get_5{});
+BENCHMARK_CAPTURE(hcp_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(ha_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(hcs_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(has_get,5, to_insert_32{},to_get_5{});
+BENCHMARK_CAPTURE(hss_get,5, to_insert_32{},to_get_5{});
+BENCHMARK_CAPTURE(hsl_get,5, to_insert_32{},to_get_5{});
+BENCHMARK_CAPTURE(hcc_get,5, to_insert_32{},to_get_5{});
+BENCHMARK_CAPTURE(hcf_get,5, to_insert_32{},to_get_5{});
+BENCHMARK_CAPTURE(haf_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(entt_ctx_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(andyg_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(entt_reg_get,5, to_insert_32{},to_get_5{});
 BENCHMARK_CAPTURE(vecany_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(mapany_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(hc_get,6, to_insert_32{},to_get_6{});
+BENCHMARK_CAPTURE(hcp_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(ha_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(hcs_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(has_get,6, to_insert_32{},to_get_6{});
+BENCHMARK_CAPTURE(hss_get,6, to_insert_32{},to_get_6{});
+BENCHMARK_CAPTURE(hsl_get,6, to_insert_32{},to_get_6{});
+BENCHMARK_CAPTURE(hcc_get,6, to_insert_32{},to_get_6{});
+BENCHMARK_CAPTURE(hcf_get,6, to_insert_32{},to_get_6{});
+BENCHMARK_CAPTURE(haf_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(entt_ctx_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(andyg_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(entt_reg_get,6, to_insert_32{},to_get_6{});
 BENCHMARK_CAPTURE(vecany_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(mapany_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(hc_get,7, to_insert_32{},to_get_7{});
+BENCHMARK_CAPTURE(hcp_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(ha_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(hcs_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(has_get,7, to_insert_32{},to_get_7{});
+BENCHMARK_CAPTURE(hss_get,7, to_insert_32{},to_get_7{});
+BENCHMARK_CAPTURE(hsl_get,7, to_insert_32{},to_get_7{});
+BENCHMARK_CAPTURE(hcc_get,7, to_insert_32{},to_get_7{});
+BENCHMARK_CAPTURE(hcf_get,7, to_insert_32{},to_get_7{});
+BENCHMARK_CAPTURE(haf_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(entt_ctx_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(andyg_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(entt_reg_get,7, to_insert_32{},to_get_7{});
 BENCHMARK_CAPTURE(vecany_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(mapany_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(hc_get,8, to_insert_32{},to_get_8{});
+BENCHMARK_CAPTURE(hcp_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(ha_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(hcs_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(has_get,8, to_insert_32{},to_get_8{});
+BENCHMARK_CAPTURE(hss_get,8, to_insert_32{},to_get_8{});
+BENCHMARK_CAPTURE(hsl_get,8, to_insert_32{},to_get_8{});
+BENCHMARK_CAPTURE(hcc_get,8, to_insert_32{},to_get_8{});
+BENCHMARK_CAPTURE(hcf_get,8, to_insert_32{},to_get_8{});
+BENCHMARK_CAPTURE(haf_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(entt_ctx_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(andyg_get,8, to_insert_32{},to_get_8{});
 BENCHMARK_CAPTURE(entt_reg_get,8, to_insert_32{},to_get_8{});
+BENCHMARK_CAPTURE(hc_teardown,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(hcd_teardown,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(ha_teardown,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(had_teardown,32, to_insert_32{},to_get_32{});
+BENCHMARK_CAPTURE(ha_gather,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(ha_naive_gather,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(ha_cold_get,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(ha_cold_prefetch_get,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(hcm_cold_get,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(hcm_cold_prefetch_get,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(hs1_cold_get,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(hs1_cold_prefetch_get,2, to_insert_8{},to_insert_2{});
+BENCHMARK_CAPTURE(hcc_get_threads,8, to_insert_32{},to_get_8{})->ThreadRange(1, max_threads());
+BENCHMARK_CAPTURE(hc_mutex_get_threads,8, to_insert_32{},to_get_8{})->ThreadRange(1, max_threads());
 BENCHMARK_MAIN();
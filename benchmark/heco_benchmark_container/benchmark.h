@@ -1,309 +1,25 @@
+#include <algorithm>
 #include <any>
 #include <variant>
 #include <tuple>
 #include <vector>
 #include <boost/align/aligned_allocator.hpp>
 #include <HeteroVector.h>
+#include <heco_1_map_array.h>
+#include <heco_1_map_stable.h>
+#include <heco_1_sparseset_array.h>
+#include <heco_1_sparseset_stable.h>
+#include <heco_1_map_concurrent.h>
 #include <entt_context.hpp>
 #include <entt.hpp>
 #include <benchmark/benchmark.h>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
 
 
-//*****************************************************************************
-// Utils
-//*****************************************************************************
-#include <tsl/robin_map.h>
-
-template<typename T>
-using rm_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
-
-using typeid_t = std::uint32_t;
-
-class TypeCounter {
-    static inline typeid_t i = 0;
-public:
-    template<typename T>
-    static inline const auto id = i++;
-};
-template<typename T> inline auto typeid_v = TypeCounter::id<rm_cvref_t<T>>;
-
-//template<typename K, typename V>
-//using map = tsl::robin_map<K,V>;
-template<typename K, typename V>
-using map = std::unordered_map<K, V>;
-//*****************************************************************************
-// Test containers
-//*****************************************************************************
-struct mapany {
-    std::unordered_map<typeid_t, std::any> data;
-    template<typename... Us, typename... Ts>
-    void insert(Ts&&... ts) {
-        data.reserve(data.size() + sizeof...(Ts));
-        (data.emplace(typeid_v<rm_cvref_t<Ts>>, std::forward<Ts>(ts)), ...);
-    }
-    template<typename T, typename U = std::remove_reference_t<T>>
-    U& get() {
-        return std::any_cast<U&>(data.at(typeid_v<U>));
-    }
-};
-
-struct heco_1_map_ptr {
-    map<typeid_t, std::unique_ptr<void, void(*)(void*)>> data;
-
-    template<typename... Ts>
-    void insert(Ts&&... ts) {
-        data.reserve(data.size() + sizeof...(Ts));
-        //(data.emplace(type_id<Ts>(), std::forward<Ts>(ts)), ...);
-        (data.emplace(typeid_v<Ts>, std::unique_ptr<void, void(*)(void*)>{ new rm_cvref_t<Ts>{ std::forward<Ts>(ts) }, [](void* instance) { delete static_cast<rm_cvref_t<Ts>*>(instance); } }), ...);
-    }
-    template<typename T, typename U = std::remove_reference_t<T>>
-    U& get() {
-        return *static_cast<U*>(data.at(typeid_v<U>).get());
-    }
-};
-#include<iostream>
-#include<cstring>
-struct heco_1_map_bytes {
-    template<typename T, size_t N>
-    using aligned_allocator = boost::alignment::aligned_allocator<T, N>;
-    constexpr static size_t max_alignment = 64;
-    using vector_bytes = std::vector<unsigned char, aligned_allocator<unsigned char, max_alignment>>;
-    vector_bytes data;
-
-    using offset_t = std::uint32_t;
-    map<typeid_t, offset_t> type_to_offset;
-
-    enum class ACTION { CONSTRUCT, COPY, MOVE, DESTROY };
-    using destructor_t = size_t(*)(void*, void*, ACTION);
-    map<typeid_t, destructor_t> destructors;
-
-    heco_1_map_bytes() = default;
-    heco_1_map_bytes(const heco_1_map_bytes&) = delete;
-    heco_1_map_bytes(heco_1_map_bytes&&) = default;
-    heco_1_map_bytes& operator=(const heco_1_map_bytes&) = delete;
-    heco_1_map_bytes& operator=(heco_1_map_bytes&&) = default;
-    ~heco_1_map_bytes() noexcept {
-        for (auto&& [tid, destructor] : destructors)
-            destructor(&data[type_to_offset[tid]], nullptr, ACTION::DESTROY);
-    }
-
-    template<typename T>
-    void record_destructor() {
-        destructors.emplace(
-            typeid_v<T>, 
-            +[](void* src, void* tgt, ACTION action) 
-            {
-                switch (action) {
-                case ACTION::CONSTRUCT: new(tgt) T; break;
-                case ACTION::DESTROY: std::destroy_at(static_cast<T*>(src)); break;
-                case ACTION::COPY: new(tgt) T{ *static_cast<T*>(src) }; break;
-                case ACTION::MOVE: new(tgt) T{ std::move(*static_cast<T*>(src)) }; break;
-                }
-                return sizeof(T); 
-            }
-        );
-    }
-
-    template<typename... T>
-    auto insert(T&&... types) {
-        const auto offsets = allocate<T...>();           //allocate
-        {size_t i = 0; (construct(offsets[i++], types), ...); }//construct
-        {size_t i = 0; (type_to_offset.emplace(typeid_v<T>, offsets[i++]), ...); }//bookkeeping
-        (record_destructor<T>(), ...);//bookkeeping
-        return offsets;
-    }
-
-    template<typename... T>
-    auto allocate()->std::array<offset_t, sizeof...(T)> {
-        static_assert(((alignof(T) <= max_alignment) && ...));
-        using namespace std;
-
-        constexpr size_t N = sizeof...(T);
-        constexpr array<size_t, N> alignments = { alignof(T)... };
-        constexpr array<size_t, N> sizes = { sizeof(T)... };
-
-        array<offset_t, N> output;
-
-        const size_t size_before = data.size();
-        uintptr_t ptr_end = uintptr_t(data.data() + size_before);
-        size_t to_allocate = 0;
-        for (int i = 0; i < N; ++i)
-        {
-            size_t padding = ((~ptr_end + 1) & (alignments[i] - 1));
-            output[i] = size_before + to_allocate + padding;
-            to_allocate += padding + sizes[i];
-            ptr_end += padding + sizes[i];
-        }
-        size_t size_after = size_before + to_allocate;
-        //data.resize(size_after);//Resizing screw up runtime on Linux "free(): invalid pointer", not moving objects is UB
-        vector_bytes tmp(size_after);
-        for (auto&& [tid, destructor] : destructors)
-            destructor(&data[type_to_offset[tid]], &tmp[type_to_offset[tid]], ACTION::MOVE);
-        data = std::exchange(tmp, {});
-        return output;
-    }
-
-    template<typename Type>
-    void construct(offset_t n, Type&& t) {
-        using U = rm_cvref_t<Type>;
-        new(&data[n]) U{ std::forward<Type>(t) };
-    }
-
-    template<typename... T>
-    auto get() -> decltype(auto) {
-        if constexpr (sizeof...(T) == 1)
-            return (get<T>(type_to_offset.at(typeid_v<T>)), ...);
-        else
-            return std::tuple<T&...>{ get<T>(type_to_offset.at(typeid_v<T>))... };
-    }
-
-    template<typename T, typename U = std::remove_reference_t<T>>
-    U& get(offset_t n) {
-        return *std::launder(reinterpret_cast<U*>(&data[n]));
-    }
-};
-
-struct heco_1_sparseset_ptr
-{
-    using ptr_t = std::unique_ptr<void, void(*)(void*)>;
-    std::vector<std::uint8_t> sparse;
-    std::vector<typeid_t>     dense;
-    std::vector<ptr_t>        objects;
-
-    template<typename T, typename... Rest>
-    decltype(auto) get()
-    {
-        using U = std::remove_reference_t<T>;
-        if constexpr (sizeof...(Rest) == 0)
-            return *static_cast<U*>(objects[sparse[typeid_v<U>]].get());
-        else
-            return std::forward_as_tuple(get<T>(), get<Rest>()...);
-    }
-
-    template<typename... Ts>
-    void insert(Ts&& ... values)
-    {
-        objects.reserve(objects.size() + sizeof...(Ts));
-        auto construct = [&](auto&& t) {
-            using T = decltype(t);
-            using U = std::remove_reference_t<decltype(t)>;
-            objects.push_back(
-                std::unique_ptr<void, void(*)(void*)>{
-                new U{ std::forward<T>(t) }, +[](void* instance) { delete static_cast<U*>(instance); } });
-        };
-        (construct(std::forward<Ts>(values)), ...);
-        // update sparse vector
-        const auto max_id = std::max({ typeid_v<Ts>... });
-        if (max_id >= sparse.size())
-            sparse.resize(max_id + 1, -1);
-        const auto ids = std::array{ typeid_v<Ts>... };
-        for (int i = ids.size(); i > 0; --i)
-            sparse[ids[i - 1]] = i - 1;
-        // update dense vector
-        dense.reserve(dense.size() + sizeof...(Ts));
-        (dense.push_back(typeid_v<Ts>), ...);
-    }
-};
-
-struct heco_1_sparseset_bytes
-{
-    template<typename T, size_t N>
-    using aligned_allocator = boost::alignment::aligned_allocator<T, N>;
-    static constexpr inline auto max_alignment = 64UL;
-    using offset_t = std::uint32_t;
-
-    enum class ACTION { CONSTRUCT, COPY, MOVE, DESTROY };
-    using destructor_t = size_t(*)(void*, void*, ACTION);
-    struct typeid_offset_dtor { typeid_t tag; offset_t offset; destructor_t dtor; };
-
-    std::vector<std::uint8_t> sparse;
-    std::vector<typeid_offset_dtor> dense;
-    using vector_bytes = std::vector<std::byte, aligned_allocator<std::byte, max_alignment>>;
-    vector_bytes objects;
-
-    heco_1_sparseset_bytes() = default;
-    heco_1_sparseset_bytes(heco_1_sparseset_bytes&&) = default;
-    heco_1_sparseset_bytes(const heco_1_sparseset_bytes&) = delete;
-    heco_1_sparseset_bytes& operator=(const heco_1_sparseset_bytes&) = delete;
-    heco_1_sparseset_bytes& operator=(heco_1_sparseset_bytes&&) = default;
-    ~heco_1_sparseset_bytes() {
-        for (auto& i : dense)
-            i.dtor(&objects[i.offset],nullptr,ACTION::DESTROY);
-    }
-
-    template<typename T>
-    auto record_destructor() {
-        return +[](void* src, void* tgt, ACTION action)
-        {
-            switch (action) {
-            case ACTION::CONSTRUCT: new(tgt) T; break;
-            case ACTION::DESTROY: std::destroy_at(static_cast<T*>(src)); break;
-            case ACTION::COPY: new(tgt) T{ *static_cast<T*>(src) }; break;
-            case ACTION::MOVE: new(tgt) T{ std::move(*static_cast<T*>(src)) }; break;
-            default: break;
-            }
-            return sizeof(T);
-        };
-    }
-
-    template<typename T>
-    decltype(auto) get() { return do_get<T>(dense[sparse[typeid_v<T>]].offset); }
-
-    template<typename T, typename U = std::remove_reference_t<T>>
-    U& do_get(offset_t n) { return *std::launder(reinterpret_cast<U*>(&objects[n])); }
-
-    template<typename... Ts>
-    void insert(Ts&&... types) {
-        // allocate and construct objects
-        const auto offsets = allocate<Ts...>();
-        auto construct = [&](offset_t n, auto&& t) {
-             using T = decltype(t);
-            using U = std::remove_reference_t<T>;
-            new(&objects[n]) U{ std::forward<T>(t) };
-        };
-        {size_t i = 0; (construct(offsets[i++], types), ...); }
-        // update sparse vector
-        const auto ids = std::array{ typeid_v<Ts>... };
-        const auto max_id = *std::max_element(ids.cbegin(), ids.end());
-        if (max_id >= sparse.size())
-            sparse.resize(max_id + 1, -1);
-        for (int i = ids.size(); i > 0; --i)
-            sparse[ids[i - 1]] = i - 1;
-        // update dense vector
-        dense.reserve(dense.size() + sizeof...(Ts));
-        {size_t i = 0; (dense.push_back({ typeid_v<Ts>,offsets[i++], record_destructor<Ts>() }), ...); }
-    }
-
-    template<typename... T>
-    auto allocate()->std::array<offset_t, sizeof...(T)> {
-        static_assert(((alignof(T) <= max_alignment) && ...));
-        using namespace std;
-
-        constexpr size_t N = sizeof...(T);
-        constexpr array<size_t, N> alignments = { alignof(T)... };
-        constexpr array<size_t, N> sizes = { sizeof(T)... };
-
-        array<offset_t, N> output;
-
-        const size_t size_before = objects.size();
-        uintptr_t ptr_end = uintptr_t(objects.data() + size_before);
-        size_t to_allocate = 0;
-        for (int i = 0; i < N; ++i)
-        {
-            size_t padding = ((~ptr_end + 1) & (alignments[i] - 1));
-            output[i] = size_before + to_allocate + padding;
-            to_allocate += padding + sizes[i];
-            ptr_end += padding + sizes[i];
-        }
-        size_t size_after = size_before + to_allocate;
-        // objects.resize(size_after);//Resizing screw up runtime on Linux "free(): invalid pointer", not moving objects is UB
-        vector_bytes tmp(size_after);
-        for (auto&& [tid, offset, dtor] : dense)
-            dtor(&objects[offset], &tmp[offset], ACTION::MOVE);
-        objects = std::exchange(tmp, {});
-        return output;
-    }
-};
+#include "benchmark_containers.h"
 
 //*****************************************************************************
 // Test functions
@@ -401,16 +117,46 @@ static void hc_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::
     }
 }
 
+static void hcp_create(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(heco::HeterogeneousContainer(heco::pooled));
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hcp_1by1_insert(benchmark::State& state, std::tuple<Args1...> to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer c(heco::pooled);
+        (c.insert(Args1{}), ...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hcp_bulk_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer c(heco::pooled);
+        c.insert(Args1{}...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hcp_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::HeterogeneousContainer c(heco::pooled);
+    c.insert(Args1{}...);
+    for (auto _ : state) {
+        (benchmark::DoNotOptimize(c.get<Args2>()), ...);
+    }
+}
+
 static void ha_create(benchmark::State& state) {
     for (auto _ : state) {
-        benchmark::DoNotOptimize(heco_1_map_bytes());
+        benchmark::DoNotOptimize(heco::HeterogeneousArray());
     }
 }
 template<typename... Args1, typename... Args2>
 static void ha_1by1_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
     std::apply([&](auto&&... args) { (typeid_v<decltype(args)>, ...); }, to_insert);
     for (auto _ : state) {
-        heco_1_map_bytes c;
+        heco::HeterogeneousArray c;
         (c.insert(Args1{}), ...);
         benchmark::DoNotOptimize(c);
     }
@@ -418,14 +164,14 @@ static void ha_1by1_insert(benchmark::State& state, std::tuple<Args1...>to_inser
 template<typename... Args1, typename... Args2>
 static void ha_bulk_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
     for (auto _ : state) {
-        heco_1_map_bytes c;
+        heco::HeterogeneousArray c;
         c.insert(Args1{}...);
         benchmark::DoNotOptimize(c);
     }
 }
 template<typename... Args1, typename... Args2>
 static void ha_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
-    heco_1_map_bytes c;
+    heco::HeterogeneousArray c;
     c.insert(Args1{}...);
     for (auto _ : state) {
         (benchmark::DoNotOptimize(c.get<Args2>()), ...);
@@ -494,6 +240,272 @@ static void has_get(benchmark::State& state, std::tuple<Args1...>to_insert, std:
     }
 }
 
+static void hss_create(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(heco::HeterogeneousContainer_SparseSet3());
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hss_1by1_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer_SparseSet3 c;
+        (c.insert(Args1{}), ...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hss_bulk_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer_SparseSet3 c;
+        c.insert(Args1{}...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hss_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::HeterogeneousContainer_SparseSet3 c;
+    c.insert(Args1{}...);
+    for (auto _ : state) {
+        (benchmark::DoNotOptimize(c.get<Args2>()), ...);
+    }
+}
+
+static void hsl_create(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(heco::HeterogeneousContainer_SparseSet3_Local());
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hsl_1by1_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer_SparseSet3_Local c;
+        (c.insert(Args1{}), ...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hsl_bulk_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer_SparseSet3_Local c;
+        c.insert(Args1{}...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hsl_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::HeterogeneousContainer_SparseSet3_Local c;
+    c.insert(Args1{}...);
+    for (auto _ : state) {
+        (benchmark::DoNotOptimize(c.get<Args2>()), ...);
+    }
+}
+
+static void hcc_create(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(heco::HeterogeneousContainer_Concurrent());
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hcc_1by1_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer_Concurrent c;
+        (c.insert(Args1{}), ...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hcc_bulk_insert(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    for (auto _ : state) {
+        heco::HeterogeneousContainer_Concurrent c;
+        c.insert(Args1{}...);
+        benchmark::DoNotOptimize(c);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void hcc_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::HeterogeneousContainer_Concurrent c;
+    c.insert(Args1{}...);
+    for (auto _ : state) {
+        (benchmark::DoNotOptimize(c.get<Args2>()), ...);
+    }
+}
+//Every thread of a run reads the same container, filled by whichever threads get there first
+template<typename... Args1, typename... Args2>
+static void hcc_get_threads(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    static heco::HeterogeneousContainer_Concurrent c;
+    c.insert(Args1{}...);
+    for (auto _ : state) {
+        (benchmark::DoNotOptimize(c.get<Args2>()), ...);
+    }
+}
+//Same with the single-threaded container behind a lock, as one would share it without hcc
+template<typename... Args1, typename... Args2>
+static void hc_mutex_get_threads(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    static heco::HeterogeneousContainer c;
+    static std::mutex mutex;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!c.contains<Args1...>())
+            c.insert(Args1{}...);
+    }
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        (benchmark::DoNotOptimize(c.get<Args2>()), ...);
+    }
+}
+static int max_threads() { return std::max(1, int(std::thread::hardware_concurrency())); }
+
+template<typename... Args1, typename... Args2>
+static void hcf_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::HeterogeneousContainer c;
+    c.insert(Args1{}...);
+    const auto frozen = std::move(c).freeze();
+    for (auto _ : state) {
+        (benchmark::DoNotOptimize(frozen.get<Args2>()), ...);
+    }
+}
+template<typename... Args1, typename... Args2>
+static void haf_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::HeterogeneousArray c;
+    c.insert(Args1{}...);
+    const auto frozen = std::move(c).freeze();
+    for (auto _ : state) {
+        (benchmark::DoNotOptimize(frozen.get<Args2>()), ...);
+    }
+}
+
+//Destruction of a batch of containers on the calling thread, immediate or deferred to a queue drained outside of the
+//timed region. Pausing the timer costs more than a teardown, hence the batch.
+template<typename Container, typename... Args1>
+static void teardown(benchmark::State& state, heco::reclaim_queue* queue) {
+    constexpr int n = 64;
+    std::vector<std::optional<Container>> containers(n);
+    for (auto _ : state) {
+        state.PauseTiming();
+        if (queue)
+            queue->drain();
+        for (auto& c : containers) {
+            if (queue)
+                c.emplace(heco::deferred, *queue);
+            else
+                c.emplace();
+            c->insert(Args1{}...);
+        }
+        state.ResumeTiming();
+        for (auto& c : containers)
+            c.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+template<typename... Args1, typename... Args2>
+static void hc_teardown(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    teardown<heco::HeterogeneousContainer, Args1...>(state, nullptr);
+}
+template<typename... Args1, typename... Args2>
+static void hcd_teardown(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::reclaim_queue queue;
+    teardown<heco::HeterogeneousContainer, Args1...>(state, &queue);
+}
+template<typename... Args1, typename... Args2>
+static void ha_teardown(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    teardown<heco::HeterogeneousArray, Args1...>(state, nullptr);
+}
+template<typename... Args1, typename... Args2>
+static void had_teardown(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    heco::reclaim_queue queue;
+    teardown<heco::HeterogeneousArray, Args1...>(state, &queue);
+}
+
+//Pointers to the objects of Args2... in many containers visited in random order, written to one vector per type
+template<bool Gather, typename... Args1, typename... Args2>
+static void ha_gather_impl(benchmark::State& state, std::tuple<Args1...>, std::tuple<Args2...>) {
+    constexpr std::size_t n = 1 << 16;
+    std::vector<heco::HeterogeneousArray> containers(n);
+    std::vector<heco::HeterogeneousArray*> order;
+    order.reserve(n);
+    for (auto& c : containers) {
+        c.insert(Args1{}...);
+        order.push_back(&c);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(0));
+    std::tuple<std::vector<Args2*>...> outputs;
+    (std::get<std::vector<Args2*>>(outputs).reserve(n), ...);
+    for (auto _ : state) {
+        (std::get<std::vector<Args2*>>(outputs).clear(), ...);
+        if constexpr (Gather)
+            heco::HeterogeneousArray::gather<Args2...>(order.begin(), order.end(), std::back_inserter(std::get<std::vector<Args2*>>(outputs))...);
+        else
+            for (heco::HeterogeneousArray* c : order)
+                (std::get<std::vector<Args2*>>(outputs).push_back(&c->get<Args2>()), ...);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+template<typename... Args1, typename... Args2>
+static void ha_gather(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    ha_gather_impl<true>(state, to_insert, to_get);
+}
+template<typename... Args1, typename... Args2>
+static void ha_naive_gather(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    ha_gather_impl<false>(state, to_insert, to_get);
+}
+
+//get<Args2...>() on many containers visited in random order, reading a byte of each object so that it comes from
+//memory. With Prefetch, the container some iterations ahead is asked to prefetch its objects, once the container itself
+//was prefetched twice as far ahead.
+template<typename Container, bool Prefetch, typename... Args1, typename... Args2>
+static void cold_get(benchmark::State& state, std::tuple<Args1...>, std::tuple<Args2...>) {
+    //The lines read for 2^20 containers outgrow a last level cache of 100MB
+    constexpr std::size_t n = 1 << 20;
+    constexpr std::size_t distance = 8;
+    std::vector<Container> containers(n);
+    std::vector<Container*> order;
+    order.reserve(n);
+    for (auto& c : containers) {
+        c.insert(Args1{}...);
+        order.push_back(&c);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(0));
+    for (auto _ : state) {
+        unsigned sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if constexpr (Prefetch) {
+                if (i + 2 * distance < n)
+                    HECO_PREFETCH(order[i + 2 * distance]);
+                if (i + distance < n)
+                    order[i + distance]->template prefetch<Args2...>();
+            }
+            sum += (unsigned(*reinterpret_cast<const unsigned char*>(&order[i]->template get<Args2>())) + ...);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+template<typename... Args1, typename... Args2>
+static void ha_cold_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    cold_get<heco::HeterogeneousArray, false>(state, to_insert, to_get);
+}
+template<typename... Args1, typename... Args2>
+static void ha_cold_prefetch_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    cold_get<heco::HeterogeneousArray, true>(state, to_insert, to_get);
+}
+template<typename... Args1, typename... Args2>
+static void hcm_cold_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    cold_get<heco::HeterogeneousContainer, false>(state, to_insert, to_get);
+}
+template<typename... Args1, typename... Args2>
+static void hcm_cold_prefetch_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    cold_get<heco::HeterogeneousContainer, true>(state, to_insert, to_get);
+}
+template<typename... Args1, typename... Args2>
+static void hs1_cold_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    cold_get<heco::HeterogeneousContainer_SparseSet, false>(state, to_insert, to_get);
+}
+template<typename... Args1, typename... Args2>
+static void hs1_cold_prefetch_get(benchmark::State& state, std::tuple<Args1...>to_insert, std::tuple<Args2...> to_get) {
+    cold_get<heco::HeterogeneousContainer_SparseSet, true>(state, to_insert, to_get);
+}
+
 static void andyg_create(benchmark::State& state) {
     for (auto _ : state) {
         benchmark::DoNotOptimize(hmdf::HeteroVector());
@@ -585,6 +597,9 @@ BENCHMARK(hc_create);
 BENCHMARK(ha_create);
 BENCHMARK(hcs_create);
 BENCHMARK(has_create);
+BENCHMARK(hss_create);
+BENCHMARK(hsl_create);
+BENCHMARK(hcc_create);
 BENCHMARK(entt_ctx_create);
 BENCHMARK(andyg_create);
 BENCHMARK(entt_reg_create);
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include <HeteroVector.h>
+#include <heco_1_map_array.h>
+#include <heco_1_map_stable.h>
+#include <heco_1_sparseset_array.h>
+#include <heco_1_sparseset_stable.h>
+#include <heco_1_map_concurrent.h>
+#include <entt_context.hpp>
+#include <entt.hpp>
+#include <benchmark/benchmark.h>
+
+#include "benchmark_containers.h"
+
+// Unlike benchmark.cpp, which hammers a single container sitting in L1, every run here builds from 10^4 up to 10^7
+// containers holding the same few objects and reads two of them from each container, in memory order or in a
+// random order. The largest data sets are well beyond the last level cache, so that the cost of the memory
+// layout of each implementation shows up. Each run reports the time per get and the heap bytes held per container.
+
+//*****************************************************************************
+// Allocation accounting
+//*****************************************************************************
+// Every allocation records its requested size in front of the returned block, so that the bytes in use are known
+// at any time. The malloc overhead is not accounted for.
+static std::atomic<std::size_t> bytes_in_use{ 0 };
+
+static void* counted_allocate(std::size_t size, std::size_t alignment)
+{
+    alignment = std::max(alignment, alignof(std::max_align_t));
+    constexpr std::size_t header = 2 * sizeof(std::uintptr_t);
+    void* base = std::malloc(size + header + alignment);
+    if (!base)
+        throw std::bad_alloc{};
+    const std::uintptr_t address = (reinterpret_cast<std::uintptr_t>(base) + header + alignment - 1) & ~(alignment - 1);
+    std::uintptr_t* record = reinterpret_cast<std::uintptr_t*>(address) - 2;
+    record[0] = size;
+    record[1] = reinterpret_cast<std::uintptr_t>(base);
+    bytes_in_use.fetch_add(size, std::memory_order_relaxed);
+    return reinterpret_cast<void*>(address);
+}
+
+static void counted_deallocate(void* p) noexcept
+{
+    if (!p)
+        return;
+    std::uintptr_t* record = static_cast<std::uintptr_t*>(p) - 2;
+    bytes_in_use.fetch_sub(record[0], std::memory_order_relaxed);
+    std::free(reinterpret_cast<void*>(record[1]));
+}
+
+void* operator new(std::size_t size) { return counted_allocate(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return counted_allocate(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return counted_allocate(size, std::size_t(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return counted_allocate(size, std::size_t(alignment)); }
+void operator delete(void* p) noexcept { counted_deallocate(p); }
+void operator delete[](void* p) noexcept { counted_deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_deallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_deallocate(p); }
+
+//*****************************************************************************
+// Test types
+//*****************************************************************************
+struct Position { float x{}, y{}, z{}; };
+struct Velocity { float dx{}, dy{}, dz{}; };
+struct Health { int value{ 100 }; };
+struct Name { std::string value{}; };
+
+//*****************************************************************************
+// Test stores
+//*****************************************************************************
+// A store holds n containers, each one filled with a Position, a Velocity, a Health and a Name,
+// and gives access to the objects of the i-th container.
+template<typename Container>
+struct many {
+    std::vector<Container> containers;
+    explicit many(std::size_t n) : containers(n) {
+        for (auto& c : containers)
+            c.insert(Position{}, Velocity{}, Health{}, Name{});
+    }
+    template<typename T>
+    decltype(auto) get(std::size_t i) { return containers[i].template get<T>(); }
+};
+
+struct many_andyg {
+    std::vector<hmdf::HeteroVector> containers;
+    explicit many_andyg(std::size_t n) : containers(n) {
+        for (auto& c : containers) {
+            c.push_back(Position{});
+            c.push_back(Velocity{});
+            c.push_back(Health{});
+            c.push_back(Name{});
+        }
+    }
+    template<typename T>
+    decltype(auto) get(std::size_t i) { return containers[i].get<T>(0); }
+};
+
+struct many_entt_ctx {
+    std::vector<entt::Context> containers;
+    explicit many_entt_ctx(std::size_t n) : containers(n) {
+        for (auto& c : containers) {
+            c.set<Position>();
+            c.set<Velocity>();
+            c.set<Health>();
+            c.set<Name>();
+        }
+    }
+    template<typename T>
+    decltype(auto) get(std::size_t i) { return containers[i].ctx<T>(); }
+};
+
+// A registry is not meant to be instantiated per object: the ECS equivalent of n containers is one entity each
+struct many_entt_reg {
+    entt::registry registry;
+    std::vector<entt::entity> entities;
+    explicit many_entt_reg(std::size_t n) : entities(n) {
+        for (auto& e : entities) {
+            e = registry.create();
+            registry.emplace<Position>(e);
+            registry.emplace<Velocity>(e);
+            registry.emplace<Health>(e);
+            registry.emplace<Name>(e);
+        }
+    }
+    template<typename T>
+    decltype(auto) get(std::size_t i) { return registry.get<T>(entities[i]); }
+};
+
+using hc = many<heco_1_map_ptr>;
+using hcs = many<heco_1_sparseset_ptr>;
+using has = many<heco_1_sparseset_bytes>;
+using ha = many<heco::HeterogeneousArray>;
+using hcm = many<heco::HeterogeneousContainer>;
+using hs1 = many<heco::HeterogeneousContainer_SparseSet>;
+using hss = many<heco::HeterogeneousContainer_SparseSet3>;
+using hsl = many<heco::HeterogeneousContainer_SparseSet3_Local>;
+using hcc = many<heco::HeterogeneousContainer_Concurrent>;
+using andyg = many_andyg;
+using entt_ctx = many_entt_ctx;
+using entt_reg = many_entt_reg;
+
+//*****************************************************************************
+// Test functions
+//*****************************************************************************
+// Gets the Position and Velocity of every container, arg 0 being the number of containers
+// and arg 1 selecting a random order of visit instead of the memory order
+template<typename Store>
+static void cold_get(benchmark::State& state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const std::size_t before = bytes_in_use.load();
+    Store store(n);
+    const std::size_t bytes = bytes_in_use.load() - before;
+
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    if (state.range(1))
+        std::shuffle(order.begin(), order.end(), std::mt19937_64{ 0 });
+
+    for (auto _ : state) {
+        float sum = 0;
+        for (auto i : order)
+            sum += store.template get<Position>(i).x + store.template get<Velocity>(i).dx;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["time/get"] = benchmark::Counter(2. * double(n), benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    state.counters["bytes/container"] = double(bytes) / double(n);
+}
+
+//*****************************************************************************
+// Loaded benchmarks
+//*****************************************************************************
+#define COLD_BENCHMARK(store) \
+    BENCHMARK_TEMPLATE(cold_get, store)->ArgsProduct({ { 10000, 100000, 1000000, 10000000 }, { 0, 1 } })->ArgNames({ "containers", "random" })->Unit(benchmark::kMillisecond)
+
+COLD_BENCHMARK(hc);
+COLD_BENCHMARK(hcs);
+COLD_BENCHMARK(has);
+COLD_BENCHMARK(ha);
+COLD_BENCHMARK(hcm);
+COLD_BENCHMARK(hs1);
+COLD_BENCHMARK(hss);
+COLD_BENCHMARK(hsl);
+COLD_BENCHMARK(hcc);
+COLD_BENCHMARK(andyg);
+COLD_BENCHMARK(entt_ctx);
+COLD_BENCHMARK(entt_reg);
+
+BENCHMARK_MAIN();
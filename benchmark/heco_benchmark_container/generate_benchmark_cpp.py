@@ -56,7 +56,7 @@ for j in range(n_test):
     content += '>;\n'
 print(content)
 
-containers = ['vecany','mapany','hc','ha','hcs','has','entt_ctx','andyg','entt_reg']
+containers = ['vecany','mapany','hc','hcp','ha','hcs','has','hss','hsl','hcc','hcf','haf','entt_ctx','andyg','entt_reg']
 tests = ['1by1_insert','bulk_insert']
 
 content += '#include "benchmark.h"\n'
@@ -71,6 +71,10 @@ for i in range(1,9,1):#for each amount of types
         for container in containers:#for each container
             if str(container+'_'+test) in bench:#if method is implemented
                 content+='BENCHMARK_CAPTURE('+container+'_'+test+','+str(i)+', to_insert_'+str(i)+'{},to_get_'+str(i)+'{});\n'
+#generate bulk insert of all types
+for container in containers:
+    if str(container+'_bulk_insert') in bench:
+        content+='BENCHMARK_CAPTURE('+container+'_bulk_insert,'+str(n_test)+', to_insert_'+str(n_test)+'{},to_get_'+str(n_test)+'{});\n'
 #generate get n types out of n types max
 tests = ['get']
 for i in range(1,9,1):#for each amount of types
@@ -79,6 +83,24 @@ for i in range(1,9,1):#for each amount of types
             if str(container+'_'+test) in bench:#if method is implemented
                 content+='BENCHMARK_CAPTURE('+container+'_'+test+','+str(i)+', to_insert_'+str(n_test)+'{},to_get_'+str(i)+'{});\n'
 
+#generate teardown of containers holding all types
+for container in ['hc','hcd','ha','had']:
+    if str(container+'_teardown') in bench:
+        content+='BENCHMARK_CAPTURE('+container+'_teardown,'+str(n_test)+', to_insert_'+str(n_test)+'{},to_get_'+str(n_test)+'{});\n'
+#generate gather of the first 2 types of containers holding 8 types, against a get() on each container
+for test in ['gather','naive_gather']:
+    if str('ha_'+test) in bench:
+        content+='BENCHMARK_CAPTURE(ha_'+test+',2, to_insert_8{},to_insert_2{});\n'
+#generate get of the first 2 types of many containers holding 8 types, out of cache, with and without prefetch
+for container in ['ha','hcm','hs1']:
+    for test in ['cold_get','cold_prefetch_get']:
+        if str(container+'_'+test) in bench:
+            content+='BENCHMARK_CAPTURE('+container+'_'+test+',2, to_insert_8{},to_insert_2{});\n'
+#generate get of 8 types out of n types max, from 1 up to every hardware thread
+for container in ['hcc','hc_mutex']:
+    if str(container+'_get_threads') in bench:
+        content+='BENCHMARK_CAPTURE('+container+'_get_threads,8, to_insert_'+str(n_test)+'{},to_get_8{})->ThreadRange(1, max_threads());\n'
+
 content+='BENCHMARK_MAIN();\n'
 print(content)
 
@@ -0,0 +1,168 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <tuple>
+#include "heco_1_map_array.h"
+#include "heco_1_static_array.h"
+
+namespace heco {
+
+    //Heterogeneous array split in two regions: the types listed in Static are stored inline at offsets known at compile
+    //time, any other type goes to a regular HeterogeneousArray. Dispatch happens at compile time, so only the types
+    //outside of the static list pay for a lookup.
+    template<typename... Static>
+    class HeterogeneousArray_Hybrid
+    {
+    public:
+        using This = HeterogeneousArray_Hybrid;
+        using Fixed = HeterogeneousArray_Static<Static...>;
+        using Dynamic = HeterogeneousArray;
+
+        template<typename T>
+        static constexpr bool is_static = Fixed::template in_schema<T>;
+
+        HeterogeneousArray_Hybrid() = default;
+        explicit HeterogeneousArray_Hybrid(std::pmr::memory_resource* resource) : dynamic(resource) {}
+        HeterogeneousArray_Hybrid(const HeterogeneousArray_Hybrid&) = delete;
+        HeterogeneousArray_Hybrid& operator=(const HeterogeneousArray_Hybrid&) = delete;
+        HeterogeneousArray_Hybrid(HeterogeneousArray_Hybrid&&) = default;
+        HeterogeneousArray_Hybrid& operator=(HeterogeneousArray_Hybrid&&) = default;
+        ~HeterogeneousArray_Hybrid() = default;
+
+    private:
+        Fixed fixed;
+        Dynamic dynamic;
+
+        template<typename T>
+        auto& part() { if constexpr (is_static<T>) return fixed; else return dynamic; }
+        template<typename T>
+        const auto& part() const { if constexpr (is_static<T>) return fixed; else return dynamic; }
+
+    public:
+        template<typename... Ts>
+        bool contains() const {
+            //Static types are single bit tests, the others are gathered in one mask for the dynamic part
+            static const type_mask in_dynamic = [] {
+                type_mask m;
+                ((is_static<Ts> ? void() : m.add(type_id<Ts>())), ...);
+                return m;
+            }();
+            return ((!is_static<Ts> || fixed.template contains<Ts>()) && ...)
+                && (in_dynamic.exact ? dynamic.presence().includes(in_dynamic.bits) : ((is_static<Ts> || dynamic.template contains<Ts>()) && ...));
+        }
+        bool contains(const type_id_t& type) const { return fixed.contains(type) || dynamic.contains(type); }
+
+        type_set presence() const noexcept { return fixed.presence() | dynamic.presence(); }
+        template<typename... Ts>
+        static const type_mask& mask() { return mask_of<Ts...>(); }
+
+        template<typename T>
+        auto has() const { return part<T>().template has<T>(); }
+
+        template<typename... Ts>
+        decltype(auto) get() const
+        {
+            static_assert(sizeof...(Ts) > 0);
+            if constexpr (sizeof...(Ts) == 1)
+                return (part<Ts>().template get<Ts>(), ...);
+            else
+                return std::forward_as_tuple(part<Ts>().template get<Ts>()...);
+        }
+
+        void reserve(size_t n_bytes, size_t n_types = 0, size_t n_destructors = 0)
+        {
+            dynamic.reserve(n_bytes, n_types, n_destructors);
+        }
+
+        template<typename... Ts>
+        void reserve()
+        {
+            (part<Ts>().template reserve<Ts>(), ...);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) construct(Args&& ... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return part<T>().template construct<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (part<Args>().construct(std::forward<Args>(args)), ...);
+            else
+                return split<Args...>([](auto& c, auto&& arg) -> decltype(auto) { return c.construct(std::forward<decltype(arg)>(arg)); }, std::forward<Args>(args)...);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) insert(Args&& ... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return part<T>().template insert<T>(std::forward<Args>(args)...);
+            else if constexpr ((is_static<Args> && ...))
+                return fixed.insert(std::forward<Args>(args)...);
+            else if constexpr ((!is_static<Args> && ...))
+                return dynamic.insert(std::forward<Args>(args)...);
+            else
+                return split<Args...>([](auto& c, auto&& arg) -> decltype(auto) { return c.insert(std::forward<decltype(arg)>(arg)); }, std::forward<Args>(args)...);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) assign(Args&&... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return part<T>().template assign<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (part<Args>().assign(std::forward<Args>(args)), ...);
+            else
+                return split<Args...>([](auto& c, auto&& arg) -> decltype(auto) { return c.assign(std::forward<decltype(arg)>(arg)); }, std::forward<Args>(args)...);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) insert_or_assign(Args&& ... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return part<T>().template insert_or_assign<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (part<Args>().insert_or_assign(std::forward<Args>(args)), ...);
+            else
+                return split<Args...>([](auto& c, auto&& arg) -> decltype(auto) { return c.insert_or_assign(std::forward<decltype(arg)>(arg)); }, std::forward<Args>(args)...);
+        }
+
+        template<typename... Ts>
+        void destruct() {
+            (part<Ts>().template destruct<Ts>(), ...);
+        }
+
+        void clear()
+        {
+            fixed.clear();
+            dynamic.clear();
+        }
+
+    private:
+        //Apply f on the region of each argument, one argument at a time
+        template<typename... Ts, typename F>
+        decltype(auto) split(F&& f, Ts&&... args)
+        {
+            static_assert((!std::is_empty_v<rm_cvref_t<Ts>> && ...), "Cannot insert a mix of static and dynamic empty types.");
+            return std::tuple<rm_cvref_t<Ts>&...>{ f(part<Ts>(), std::forward<Ts>(args))... };
+        }
+    };
+}
@@ -19,6 +19,7 @@
 // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
+#pragma once
 #include <cassert>
 #include <cstddef>
 #include <array>
@@ -27,12 +28,56 @@
 #include <numeric>
 #include <boost/align/aligned_allocator.hpp>
 #include <boost/container/static_vector.hpp>
+#include <boost/container/small_vector.hpp>
 #include <unordered_map>
+#include <stdexcept>
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <optional>
+#include <memory_resource>
+#include "heco_frozen.h"
+#include "heco_packing.h"
+#include "heco_reclaim_queue.h"
+#include "heco_type_set.h"
+#include "heco_type_registry.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HECO_SSE2
+#endif
 
 namespace heco {
     template<typename T, size_t N>
     using aligned_allocator = boost::alignment::aligned_allocator<T, N>;
 
+    //Allocator drawing from a std::pmr::memory_resource, by default the one current at construction, with blocks
+    //aligned on at least Alignment. Unlike std::pmr::polymorphic_allocator, the resource follows the storage when a
+    //container is moved, so that objects never get copied to another resource byte by byte.
+    template<typename T, size_t Alignment = alignof(T)>
+    struct resource_allocator
+    {
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        template<typename U> struct rebind { using other = resource_allocator<U, Alignment>; };
+        static constexpr std::size_t alignment = std::max(Alignment, alignof(T));
+
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
+        resource_allocator() noexcept = default;
+        resource_allocator(std::pmr::memory_resource* resource) noexcept : resource(resource) {}
+        template<typename U>
+        resource_allocator(const resource_allocator<U, Alignment>& other) noexcept : resource(other.resource) {}
+
+        T* allocate(std::size_t n) { return static_cast<T*>(resource->allocate(n * sizeof(T), alignment)); }
+        void deallocate(T* p, std::size_t n) noexcept { resource->deallocate(p, n * sizeof(T), alignment); }
+
+        template<typename U>
+        bool operator==(const resource_allocator<U, Alignment>& other) const noexcept { return *resource == *other.resource; }
+        template<typename U>
+        bool operator!=(const resource_allocator<U, Alignment>& other) const noexcept { return !(*this == other); }
+    };
+
     template<typename T, size_t N>
     using vector_fixed_capacity = boost::container::static_vector<T, N>;
 
@@ -45,15 +90,21 @@ namespace heco {
     template<typename T = void, typename... Ts>
     constexpr bool all_types_different = !std::disjunction_v<std::is_same<T, Ts>...> && (sizeof...(Ts) > 0) ? all_types_different<Ts...> : true;
 
-    using type_id_t = std::uint32_t;
+    //Whether moving a T to another address then destroying the original amounts to copying its bytes.
+    //Specialize it to true for types that are relocatable without being trivially copyable (e.g. most std::vector).
+    template<typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+    template<typename T>
+    constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
 
-    class TypeCounter {
-        static inline type_id_t i = 0;
-    public:
-        template<typename T>
-        static inline const auto id = i++;
-    };
-    template<typename T> inline auto type_id() { return TypeCounter::id<rm_cvref_t<T>>; }
+    template<typename T> inline auto type_id() { return dense_type_id<rm_cvref_t<T>>(); }
+
+    //Bits of Ts... in the type sets of the containers numbering types with type_id, computed on first use
+    template<typename... Ts>
+    const type_mask& mask_of() {
+        static const type_mask m = type_mask::of(type_id<Ts>()...);
+        return m;
+    }
 
     template<typename T, std::size_t N>
     struct array : std::array<T, N> {
@@ -61,64 +112,482 @@ namespace heco {
         constexpr operator const T& () const { return (*this)[0]; }
         template<size_t M = N, typename = std::enable_if_t<M == 1>>//https://stackoverflow.com/questions/18100297/how-can-i-use-stdenable-if-in-a-conversion-operator | https://godbolt.org/z/PHVy-L
         constexpr operator T& () { return (*this)[0]; }
+        template<size_t M = N, typename = std::enable_if_t<M == 1>>
+        friend constexpr bool operator==(const array& a, const T& b) { return a[0] == b; }
+        template<size_t M = N, typename = std::enable_if_t<M == 1>>
+        friend constexpr bool operator==(const T& a, const array& b) { return a == b[0]; }
     };
     template<typename T, typename... Ts, typename = std::enable_if_t<(std::is_same_v<T, Ts>&& ...)>>
     array(T t, Ts... ts)->array<T, 1 + sizeof...(Ts)>;//template deduction guide needed
 
     constexpr size_t default_alignment = 64;
 
-    class HeterogeneousArray
+    template<bool Segmented, std::size_t InlineCapacity>
+    class BasicHeterogeneousArray;
+
+    //Handle holding the offsets of Ts... in a container resolved once, accessing through it does not search the metadata.
+    //Offsets survive reallocation of the buffer, but destructing, clearing or moving the container invalidates it.
+    template<typename Container, typename... Ts>
+    class ArrayView
+    {
+        static_assert(sizeof...(Ts) > 0);
+        static_assert((!std::is_empty_v<rm_cvref_t<Ts>> && ...), "Empty types have no storage to view");
+        template<bool, std::size_t> friend class BasicHeterogeneousArray;
+
+        using offset_t = typename Container::offset_t;
+
+        const Container* container;
+        std::array<offset_t, sizeof...(Ts)> offsets;
+        std::uint32_t generation;
+
+        explicit ArrayView(const Container& c)
+            : container(&c), offsets(c.template offset_of<Ts...>()), generation(c.generation) {}
+
+        template<typename T>
+        static constexpr std::size_t index_of()
+        {
+            static_assert((std::is_same_v<rm_cvref_t<T>, rm_cvref_t<Ts>> || ...), "Type is not part of the view");
+            constexpr bool matches[] = { std::is_same_v<rm_cvref_t<T>, rm_cvref_t<Ts>>... };
+            std::size_t i = 0;
+            while (!matches[i])
+                ++i;
+            return i;
+        }
+
+    public:
+        bool valid() const noexcept { return container->generation == generation; }
+
+        template<std::size_t I>
+        decltype(auto) get() const noexcept
+        {
+            assert(valid() && "Container changed since the view was made");
+            return container->template do_get<std::tuple_element_t<I, std::tuple<Ts...>>>(offsets[I]);
+        }
+
+        template<typename T>
+        decltype(auto) get() const noexcept { return get<index_of<T>()>(); }
+
+        std::tuple<Ts&...> tuple() const noexcept { return tuple(std::index_sequence_for<Ts...>{}); }
+
+    private:
+        template<std::size_t... I>
+        std::tuple<Ts&...> tuple(std::index_sequence<I...>) const noexcept
+        {
+            assert(valid() && "Container changed since the view was made");
+            return { container->template do_get<Ts>(offsets[I])... };
+        }
+    };
+
+    //Byte storage made of cache-aligned chunks which are never reallocated, objects placed in it never move.
+    //An offset holds the index of its chunk in the upper bits and the position inside the chunk in the lower bits.
+    class segmented_bytes
+    {
+    public:
+        using offset_t = std::uint32_t;
+        static constexpr unsigned index_bits = 8;
+        static constexpr unsigned position_bits = 32 - index_bits;
+        static constexpr std::size_t max_segments = std::size_t(1) << index_bits;
+        static constexpr std::size_t max_segment_size = std::size_t(1) << position_bits;
+        static constexpr std::size_t min_segment_size = 4 * default_alignment;
+
+        static constexpr offset_t encode(std::size_t segment, std::size_t position) { return offset_t(segment << position_bits | position); }
+        static constexpr std::size_t segment_of(offset_t n) { return n >> position_bits; }
+        static constexpr std::size_t position_of(offset_t n) { return n & (max_segment_size - 1); }
+
+        using allocator_type = resource_allocator<std::byte, default_alignment>;
+
+        segmented_bytes() = default;
+        explicit segmented_bytes(const allocator_type& allocator) : segments(allocator.resource), allocator(allocator) {}
+        segmented_bytes(const segmented_bytes&) = delete;
+        segmented_bytes& operator=(const segmented_bytes&) = delete;
+        segmented_bytes(segmented_bytes&& other) noexcept
+            : segments(std::move(other.segments)), allocator(other.allocator), used(std::exchange(other.used, 0)), total(std::exchange(other.total, 0)) {
+            other.segments.clear();
+        }
+        segmented_bytes& operator=(segmented_bytes&& other) noexcept {
+            if (this != &other) {
+                clear();
+                segments = std::move(other.segments);
+                other.segments.clear();
+                allocator = other.allocator;
+                used = std::exchange(other.used, 0);
+                total = std::exchange(other.total, 0);
+            }
+            return *this;
+        }
+        ~segmented_bytes() { clear(); }
+
+        std::byte& operator[](offset_t n) const noexcept
+        {
+            assert(segment_of(n) < segments.size() && position_of(n) < segments[segment_of(n)].size);
+            return segments[segment_of(n)].data[position_of(n)];
+        }
+
+        //Bytes handed out, padding included
+        std::size_t size() const noexcept { return total; }
+        std::size_t capacity() const noexcept {
+            return std::accumulate(segments.begin(), segments.end(), std::size_t(0), [](std::size_t n, const segment& s) { return n + s.size; });
+        }
+        bool empty() const noexcept { return total == 0; }
+        allocator_type get_allocator() const noexcept { return allocator; }
+        //Bytes left in the last chunk
+        std::size_t available() const noexcept { return segments.empty() ? 0 : segments.back().size - used; }
+
+        void reserve(std::size_t n_bytes)
+        {
+            if (n_bytes > total + available())
+                add_segment(n_bytes - total);
+        }
+
+        template<std::size_t N>
+        std::array<offset_t, N> allocate(const std::array<std::size_t, N>& alignments, const std::array<std::size_t, N>& sizes)
+        {
+            auto layout = pack(alignments, sizes, segments.empty() ? 0 : std::uintptr_t(segments.back().data + used));
+            if (segments.empty() || layout.size > available()) {
+                layout = pack(alignments, sizes);
+                add_segment(layout.size);
+            }
+            return place(layout);
+        }
+
+        template<typename... Ts>
+        std::array<offset_t, sizeof...(Ts)> allocate()
+        {
+            using table = packing_table<Ts...>;
+            if (segments.empty() || table::at(std::uintptr_t(segments.back().data + used)).size > available())
+                add_segment(table::layouts[0].size);
+            return place(table::at(std::uintptr_t(segments.back().data + used)));
+        }
+
+        //Contiguous block of n_bytes starting where the last allocation ended, or at the start of a new chunk
+        offset_t allocate(std::size_t n_bytes)
+        {
+            if (segments.empty() || n_bytes > available())
+                add_segment(n_bytes);
+            const offset_t output = encode(segments.size() - 1, used);
+            used += n_bytes;
+            total += n_bytes;
+            return output;
+        }
+
+        void clear() noexcept
+        {
+            for (const segment& s : segments)
+                allocator.deallocate(s.data, s.size);
+            segments.clear();
+            used = total = 0;
+        }
+
+    private:
+        struct segment {
+            std::byte* data;
+            std::size_t size;
+        };
+        std::vector<segment, resource_allocator<segment>> segments;
+        allocator_type allocator;
+        std::size_t used = 0;//< bytes taken in the last chunk
+        std::size_t total = 0;
+
+        template<std::size_t N>
+        std::array<offset_t, N> place(const packing<N>& layout)
+        {
+            std::array<offset_t, N> output;
+            for (std::size_t i = 0; i < N; ++i)
+                output[i] = encode(segments.size() - 1, used + layout.offsets[i]);
+            used += layout.size;
+            total += layout.size;
+            return output;
+        }
+
+        void add_segment(std::size_t at_least)
+        {
+            const std::size_t previous = segments.empty() ? 0 : segments.back().size;
+            const std::size_t rounded = (at_least + default_alignment - 1) & ~(default_alignment - 1);
+            const std::size_t n = std::min(std::max({ min_segment_size, 2 * previous, rounded }), max_segment_size);
+            assert(rounded <= max_segment_size && "Object too large for a segment");
+            assert(segments.size() < max_segments && "Too many segments");
+            segments.push_back(segment{ allocator.allocate(n), n });
+            used = 0;
+        }
+    };
+
+    //Byte buffer keeping up to InlineCapacity bytes inside the object before spilling to an aligned heap block.
+    //Moving or growing it copies bytes, relocating the objects living inside is left to the owner.
+    template<std::size_t InlineCapacity>
+    class small_bytes
+    {
+        static_assert(InlineCapacity > 0);
+    public:
+        using allocator_type = resource_allocator<std::byte, default_alignment>;
+
+        small_bytes() noexcept = default;
+        explicit small_bytes(const allocator_type& allocator) noexcept : allocator(allocator) {}
+        small_bytes(const small_bytes&) = delete;
+        small_bytes& operator=(const small_bytes&) = delete;
+        small_bytes(small_bytes&& other) noexcept { steal(other); }
+        small_bytes& operator=(small_bytes&& other) noexcept {
+            if (this != &other) {
+                release();
+                steal(other);
+            }
+            return *this;
+        }
+        ~small_bytes() { release(); }
+
+        std::byte* data() const noexcept { return ptr; }
+        std::byte& operator[](std::size_t n) const noexcept { return ptr[n]; }
+        std::size_t size() const noexcept { return count; }
+        std::size_t capacity() const noexcept { return cap; }
+        bool empty() const noexcept { return count == 0; }
+        bool is_inline() const noexcept { return ptr == buffer; }
+        allocator_type get_allocator() const noexcept { return allocator; }
+
+        void reserve(std::size_t n)
+        {
+            if (n <= cap)
+                return;
+            std::byte* block = allocator.allocate(n);
+            if (count > 0)
+                std::memcpy(block, ptr, count);
+            release();
+            ptr = block;
+            cap = n;
+        }
+        //Bytes added are left uninitialized
+        void resize(std::size_t n)
+        {
+            reserve(n);
+            count = n;
+        }
+        void clear() noexcept { count = 0; }
+        //Empty the buffer and give back the heap block, if any
+        void shrink_to_inline() noexcept
+        {
+            count = 0;
+            release();
+        }
+
+    private:
+        alignas(default_alignment) mutable std::byte buffer[InlineCapacity];
+        std::byte* ptr = buffer;
+        std::size_t count = 0;
+        std::size_t cap = InlineCapacity;
+        allocator_type allocator;
+
+        void release() noexcept
+        {
+            if (!is_inline())
+                allocator.deallocate(ptr, cap);
+            ptr = buffer;
+            cap = InlineCapacity;
+        }
+        void steal(small_bytes& other) noexcept
+        {
+            if (other.is_inline())
+                std::memcpy(buffer, other.buffer, other.count);
+            else {
+                ptr = other.ptr;
+                cap = other.cap;
+                allocator = other.allocator;
+            }
+            count = other.count;
+            other.ptr = other.buffer;
+            other.cap = InlineCapacity;
+            other.count = 0;
+        }
+    };
+
+    //Heterogeneous container storing at most one object per type in a single byte buffer. In segmented mode, the
+    //buffer is a list of chunks instead so that inserting never moves existing objects, see segmented_bytes.
+    //With InlineCapacity > 0, the first InlineCapacity bytes and a small metadata table live inside the container, so
+    //that small bundles do not allocate at all.
+    //All the memory, objects and tables, comes from the std::pmr::memory_resource given at construction, e.g. a
+    //std::pmr::monotonic_buffer_resource to release a batch of short-lived containers at once.
+    template<bool Segmented, std::size_t InlineCapacity = 0>
+    class BasicHeterogeneousArray
     {
+        static_assert(!Segmented || InlineCapacity == 0, "Segmented storage has no inline buffer");
+        static constexpr std::size_t inline_types = std::max<std::size_t>(1, InlineCapacity / 16);
+        template<typename T>
+        using table_t = std::conditional_t<(InlineCapacity > 0),
+            boost::container::small_vector<T, inline_types, resource_allocator<T>>, std::vector<T, resource_allocator<T>>>;
+        template<typename T>
+        static typename table_t<T>::allocator_type table_allocator(std::pmr::memory_resource* resource) {
+            return typename table_t<T>::allocator_type(resource_allocator<T>(resource));
+        }
+        using buffer_t = std::conditional_t<Segmented, segmented_bytes,
+            std::conditional_t<(InlineCapacity > 0), small_bytes<InlineCapacity>, std::vector<std::byte, resource_allocator<std::byte, default_alignment>>>>;
+
+        template<typename, typename...> friend class ArrayView;
+
     public:
-        using This = HeterogeneousArray;
+        using This = BasicHeterogeneousArray;
         using offset_t = std::uint32_t;
-        using destructor_t = void(*)(This&);
+        using destructor_t = void(*)(void*);
+        using relocator_t = void(*)(void* from, void* to);
+
+        enum flags_t : std::uint32_t { CONSTRUCTED = 1 };
+        struct metadata_t {
+            offset_t offset;
+            std::uint32_t flags;
+            std::uint32_t size;//< bytes taken in the buffer, 0 for empty types
+            std::uint32_t alignment;
+            destructor_t destructor;//< nullptr when there is nothing to destroy
+            relocator_t relocate;//< nullptr when copying the bytes is enough
+        };
+
+        template<typename... Ts>
+        using View = ArrayView<This, Ts...>;
 
-        HeterogeneousArray() = default;
-        HeterogeneousArray(const HeterogeneousArray&) = delete;
-        HeterogeneousArray& operator=(const HeterogeneousArray&) = delete;
-        HeterogeneousArray(HeterogeneousArray&&) = default;
-        HeterogeneousArray& operator=(HeterogeneousArray&&) = default;
-        ~HeterogeneousArray() {
-            for (auto [tid, destructor] : destructors)
-                destructor(*this);
+        BasicHeterogeneousArray() = default;
+        explicit BasicHeterogeneousArray(std::pmr::memory_resource* resource)
+            : types(table_allocator<type_id_t>(resource)), metadata(table_allocator<metadata_t>(resource))
+            , data(typename buffer_t::allocator_type(resource)), holes(table_allocator<hole_t>(resource)) {}
+        //Objects are allocated from resource and destroyed by queue once the container is, see reclaim_queue: resource
+        //must be thread-safe when the queue runs a thread of its own, which this does not check.
+        //Retiring moves the storage and tables: with an inline buffer, it would move the objects themselves on the
+        //calling thread, hence deferred mode is only available with heap storage.
+        BasicHeterogeneousArray(deferred_t, reclaim_queue& queue, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : BasicHeterogeneousArray(resource)
+        {
+            static_assert(InlineCapacity == 0, "Deferred mode needs the objects on the heap, use HeterogeneousArray");
+            reclaim = &queue;
+        }
+        BasicHeterogeneousArray(const BasicHeterogeneousArray&) = delete;
+        BasicHeterogeneousArray& operator=(const BasicHeterogeneousArray&) = delete;
+        BasicHeterogeneousArray(BasicHeterogeneousArray&& other) noexcept
+            : types(std::move(other.types)), metadata(std::move(other.metadata)), data(other.data.get_allocator()), holes(std::move(other.holes))
+            , present(other.present), reclaim(other.reclaim)
+        {
+            take_data(other);
+            other.present.clear();
+            other.types.clear();
+            other.metadata.clear();
+            other.holes.clear();
+            ++other.generation;
         }
+        BasicHeterogeneousArray& operator=(BasicHeterogeneousArray&& other) {
+            if (this != &other) {
+                if (reclaim)
+                    retire();
+                destroy_all();
+                types = std::move(other.types);
+                metadata = std::move(other.metadata);
+                take_data(other);
+                holes = std::move(other.holes);
+                present = other.present;
+                reclaim = other.reclaim;
+                other.present.clear();
+                other.types.clear();
+                other.metadata.clear();
+                other.holes.clear();
+                ++other.generation;
+                ++generation;
+            }
+            return *this;
+        }
+        ~BasicHeterogeneousArray() {
+            if (reclaim)
+                retire();
+            destroy_all();
+        }
+
+        std::pmr::memory_resource* resource() const noexcept { return data.get_allocator().resource; }
 
     private:
-        map<type_id_t, offset_t> offsets;
-        mutable std::vector<std::byte, aligned_allocator<std::byte, default_alignment>> data;
-        map<type_id_t, destructor_t> destructors;
+        //Metadata table sorted by type, the keys are stored apart to be compared several at once
+        table_t<type_id_t> types;
+        table_t<metadata_t> metadata;
+        mutable buffer_t data;
+        std::uint32_t generation = 0;//< bumped whenever an existing object may go away
+        struct hole_t {
+            std::uint32_t size;
+            offset_t offset;
+        };
+        table_t<hole_t> holes;//< slots left by erase
+        type_set present;//< types constructed
+        reclaim_queue* reclaim = nullptr;//< destroys the objects in deferred mode
+
+        static constexpr std::size_t linear_search_max = 32;
+
+        //Position of type in the metadata table, or types.size() when absent
+        std::size_t find(const type_id_t& type) const noexcept
+        {
+            const std::size_t n = types.size();
+            const type_id_t* keys = types.data();
+            if (n > linear_search_max) {
+                const type_id_t* it = std::lower_bound(keys, keys + n, type);
+                return (it != keys + n && *it == type) ? std::size_t(it - keys) : n;
+            }
+            std::size_t i = 0;
+#ifdef HECO_SSE2
+            static_assert(sizeof(type_id_t) == 4);
+            const __m128i key = _mm_set1_epi32(int(type));
+            for (; i + 4 <= n; i += 4) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+                const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, key)));
+                if (mask)
+                    return i + ((mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3);
+            }
+#endif
+            for (; i < n; ++i)
+                if (keys[i] == type)
+                    return i;
+            return n;
+        }
+
+        const metadata_t& at(const type_id_t& type) const
+        {
+            const std::size_t i = find(type);
+            if (i == types.size())
+                throw std::out_of_range("heco::HeterogeneousArray: type not allocated");
+            return metadata[i];
+        }
+        metadata_t& at(const type_id_t& type) { return const_cast<metadata_t&>(std::as_const(*this).at(type)); }
 
     public:
-        bool is_allocated(const type_id_t& type) const { return offsets.count(type); }
+        bool is_allocated(const type_id_t& type) const { return find(type) != types.size(); }
         template<typename T>
         bool is_allocated() const { return is_allocated(type_id<T>()); }
 
-        bool is_constructed(const type_id_t& type) const { return destructors.count(type); }
+        bool is_constructed(const type_id_t& type) const {
+            const std::size_t i = find(type);
+            return i != types.size() && (metadata[i].flags & CONSTRUCTED);
+        }
         template<typename T>
         bool is_constructed() const { return is_constructed(type_id<T>()); }
 
-        bool contains(const type_id_t& type) const { return is_constructed(type); }
+        bool contains(const type_id_t& type) const { return type_set::representable(type) ? present.test(type) : is_constructed(type); }
         template<typename... Ts>
-        bool contains() const { return (contains(type_id<Ts>()) && ...); }
+        bool contains() const {
+            const type_mask& m = mask<Ts...>();
+            return m.exact ? present.includes(m.bits) : (contains(type_id<Ts>()) && ...);
+        }
+
+        //Types constructed in the container, to be tested against mask<Ts...>()
+        const type_set& presence() const noexcept { return present; }
+        template<typename... Ts>
+        static const type_mask& mask() { return mask_of<Ts...>(); }
 
         template<typename T, typename U = rm_cvref_t<T>>
         auto has() const {
-            const type_id_t tid = type_id<U>();
+            const std::size_t i = find(type_id<U>());
+            const bool found = i != types.size() && (metadata[i].flags & CONSTRUCTED);
             if constexpr (std::is_empty_v<U>)
-                return contains(tid);
-            else {
-                if (contains(tid))
-                    return &get<U>(offsets.at(tid));
-                else
-                    return (U*)nullptr;
-            }
+                return found;
+            else
+                return found ? &do_get<U>(metadata[i].offset) : (U*)nullptr;
         }
 
+        //Hint the cache to load the objects of Ts... ahead of get<Ts...>(), e.g. for the container processed a few
+        //iterations later. Finding their address reads the metadata, the objects themselves are not read.
+        template<typename... Ts>
+        void prefetch() const noexcept { (prefetch_1(type_id<Ts>()), ...); }
+
         template<typename T, typename... Rest>
         auto offset_of() const
         {
-            return array{ offsets.at(type_id<T>()), offsets.at(type_id<Rest>())... };
+            return array{ at(type_id<T>()).offset, at(type_id<Rest>()).offset... };
         }
 
         template<typename T, typename... Rest>
@@ -128,10 +597,10 @@ namespace heco {
         }
 
         template<typename... Ts>
-        decltype(auto) get() const noexcept
+        decltype(auto) get() const
         {
             static_assert(sizeof...(Ts) > 0);
-            return get<Ts...>(offsets.at(type_id<Ts>()) ...);
+            return get<Ts...>(at(type_id<Ts>()).offset ...);
         }
 
         template<typename T, typename... Rest, typename Id, typename... Ids>
@@ -139,8 +608,7 @@ namespace heco {
         {
             static_assert(sizeof...(Rest) == sizeof...(Ids));
             static_assert(std::is_convertible_v<Id, offset_t> && (std::is_convertible_v<Ids, offset_t> && ...));
-            assert(offsets.at(type_id<T>()) == off && ((offsets.at(type_id<Rest>()) == offs) && ...));
-            auto*const p = data.data();
+            assert(at(type_id<T>()).offset == off && ((at(type_id<Rest>()).offset == offs) && ...));
             if constexpr (sizeof...(Rest) == 0)
                 return do_get<T>(off);
             else
@@ -159,16 +627,23 @@ namespace heco {
             }
         }
 
+        template<typename... Ts>
+        View<Ts...> view() const
+        {
+            assert(contains<Ts...>());
+            return View<Ts...>(*this);
+        }
+
         template<typename... Ts>
         auto reserve()
         {
             constexpr auto N = sizeof...(Ts);
             assert((!is_allocated<Ts>() && ...));
             const auto offsets_to_insert = do_allocate<Ts...>();
-            offsets.reserve(offsets.size() + N);
-            destructors.reserve(destructors.size() + N);
+            types.reserve(types.size() + N);
+            metadata.reserve(metadata.size() + N);
             unsigned i = 0;
-            (offsets.emplace(type_id<Ts>(), offsets_to_insert[i++]), ...);
+            (record_type<Ts>(offsets_to_insert[i++]), ...);
             if constexpr (sizeof...(Ts) == 1)
                 return offsets_to_insert[0];
             else
@@ -177,9 +652,12 @@ namespace heco {
 
         void reserve(size_t n_bytes, size_t n_types = 0, size_t n_destructors = 0)
         {
-            data.reserve(n_bytes);
-            offsets.reserve(n_types);
-            destructors.reserve(n_destructors);
+            if constexpr (Segmented)
+                data.reserve(n_bytes);
+            else if (n_bytes > data.capacity())
+                reallocate(n_bytes);
+            types.reserve(std::max(n_types, n_destructors));
+            metadata.reserve(std::max(n_types, n_destructors));
         }
 
         template<typename T = void, typename... Args>
@@ -237,12 +715,119 @@ namespace heco {
             (do_destruct<Ts>(), ...);
         }
 
+        //Destroy the objects of types Ts... and forget about them, their slots are reused by later insertions
+        template<typename... Ts>
+        void erase() {
+            (do_erase<Ts>(), ...);
+        }
+
+        //Repack every allocated object from scratch, dropping holes and padding, and return the bytes of buffer capacity
+        //released, 0 when the buffer did not shrink. The scratch tables come from the resource of the container.
+        //Objects move, so offsets, references and views obtained before are invalidated, in segmented mode too.
+        std::size_t compact()
+        {
+            table_t<std::size_t> index(table_allocator<std::size_t>(resource()));
+            table_t<std::size_t> alignments(table_allocator<std::size_t>(resource()));
+            table_t<std::size_t> sizes(table_allocator<std::size_t>(resource()));
+            index.reserve(metadata.size());
+            alignments.reserve(metadata.size());
+            sizes.reserve(metadata.size());
+            for (std::size_t i = 0; i < metadata.size(); ++i) {
+                if (metadata[i].size == 0)
+                    continue;
+                index.push_back(i);
+                alignments.push_back(metadata[i].alignment);
+                sizes.push_back(metadata[i].size);
+            }
+            table_t<std::size_t> offsets(index.size(), table_allocator<std::size_t>(resource()));
+            table_t<char> placed(index.size(), false, table_allocator<char>(resource()));
+            const std::size_t size = pack_n(alignments, sizes, offsets, placed, index.size());
+
+            buffer_t buffer(data.get_allocator());
+            offset_t base = 0;
+            buffer.reserve(size);
+            if constexpr (Segmented) {
+                if (size > 0)
+                    base = buffer.allocate(size);
+            }
+            else
+                buffer.resize(size);
+            for (std::size_t k = 0; k < index.size(); ++k) {
+                metadata_t& m = metadata[index[k]];
+                const offset_t to = offset_t(base + offsets[k]);
+                if (m.flags & CONSTRUCTED) {
+                    if (m.relocate)
+                        m.relocate(&data[m.offset], &buffer[to]);
+                    else
+                        std::memcpy(&buffer[to], &data[m.offset], m.size);
+                }
+                m.offset = to;
+            }
+            const std::size_t before = data.capacity();
+            if constexpr (InlineCapacity > 0) {
+                if (buffer.is_inline()) {
+                    data.shrink_to_inline();
+                    data.resize(size);
+                    transfer(buffer, data);
+                }
+                else
+                    data = std::move(buffer);
+            }
+            else
+                data = std::move(buffer);
+            holes.clear();
+            ++generation;
+            return before > data.capacity() ? before - data.capacity() : 0;
+        }
+
+        //Containers ahead of the one being read whose metadata gather() prefetches, twice as far for the containers
+        static constexpr std::ptrdiff_t gather_distance = 8;
+
+        //Write the objects of types Ts... held by the containers pointed by [first, last), a random access range, to
+        //one output iterator per type, in structure-of-arrays. An output taking U* receives pointers, nullptr for a
+        //container without U, any other receives copies and throws std::out_of_range on a container without U, the
+        //objects gathered before being left written. The positions of Ts... in the metadata table are tried first on
+        //the next container, so that containers filled alike skip the search. Returns the outputs past the end.
+        template<typename... Ts, typename It, typename... Outs>
+        static std::tuple<Outs...> gather(It first, It last, Outs... outs)
+        {
+            static_assert(sizeof...(Ts) > 0 && sizeof...(Ts) == sizeof...(Outs), "One output per type");
+            static_assert(((!std::is_empty_v<Ts>) && ...), "Empty types have no object to gather");
+            const std::ptrdiff_t n = last - first;
+            const type_id_t ids[sizeof...(Ts)] = { type_id<Ts>()... };
+            std::size_t positions[sizeof...(Ts)] = {};
+            for (std::ptrdiff_t i = 0; i < n; ++i) {
+                if (i + 2 * gather_distance < n)
+                    HECO_PREFETCH(&*first[i + 2 * gather_distance]);
+                if (i + gather_distance < n) {
+                    const This& ahead = *first[i + gather_distance];
+                    HECO_PREFETCH(ahead.types.data() + positions[0]);
+                    for (std::size_t position : positions)
+                        HECO_PREFETCH(ahead.metadata.data() + position);
+                }
+                const This& c = *first[i];
+                std::size_t k = 0;
+                ((gather_1<Ts>(c, ids[k], positions[k], outs), ++k), ...);
+            }
+            return { outs... };
+        }
+
+        //Compact the objects and hand them over to a read-only container indexed by a perfect hash, for threads to share
+        //once filled. Objects move as with compact().
+        Frozen<This, void> freeze() &&
+        {
+            compact();
+            return Frozen<This, void>(std::move(*this));
+        }
+
         void clear()
         {
-            for (auto [tid, destructor] : destructors)
-                destructor(*this);
-            destructors.clear();
-            offsets.clear();
+            destroy_all();
+            ++generation;
+            present.clear();
+            types.clear();
+            metadata.clear();
+            holes.clear();
             data.clear();
         }
 
@@ -252,16 +837,86 @@ namespace heco {
         template<typename T>
         static constexpr bool must_be_moveable_if_rvalue = (std::is_object_v<T> || std::is_rvalue_reference_v<T>) && std::is_move_constructible_v<T>;
 
-        template<typename T>
-        void record_type(offset_t to_add) { offsets.emplace(type_id<T>(), to_add); }
-        void record_type(const type_id_t& type, offset_t to_add) { offsets.emplace(type, to_add); }
+        template<typename, typename> friend class Frozen;
+
+        void prefetch_1(type_id_t type) const noexcept
+        {
+            const std::size_t i = find(type);
+            if (i != types.size() && metadata[i].size > 0)
+                HECO_PREFETCH(&data[metadata[i].offset]);
+        }
+
+        template<typename T, typename Out>
+        static void gather_1(const This& c, type_id_t id, std::size_t& position, Out& out)
+        {
+            using U = rm_cvref_t<T>;
+            if (position >= c.types.size() || c.types[position] != id)
+                position = c.find(id);
+            const bool found = position < c.types.size() && (c.metadata[position].flags & CONSTRUCTED);
+            if constexpr (std::is_assignable_v<decltype(*out), U*>)
+                *out = found ? &c.template do_get<U>(c.metadata[position].offset) : nullptr;
+            else {
+                if (!found)
+                    throw std::out_of_range("heco::HeterogeneousArray::gather: type not constructed");
+                *out = c.template do_get<U>(c.metadata[position].offset);
+            }
+            ++out;
+        }
+
+        //Hand the objects and tables over to the reclaim queue, which destroys them later, and leave the container empty
+        void retire()
+        {
+            if (types.empty())
+                return;
+            reclaim_queue* queue = std::exchange(reclaim, nullptr);
+            queue->retire(This(std::move(*this)));
+            reclaim = queue;
+        }
+
+        //Calls f(id, address) for every object constructed, address being nullptr for empty types
+        template<typename F>
+        void visit_objects(F&& f) const
+        {
+            for (std::size_t i = 0; i < types.size(); ++i)
+                if (metadata[i].flags & CONSTRUCTED)
+                    f(types[i], metadata[i].size ? static_cast<void*>(&data[metadata[i].offset]) : nullptr);
+        }
+
+        void destroy_all()
+        {
+            for (const metadata_t& m : metadata)
+                if (m.destructor && (m.flags & CONSTRUCTED))
+                    m.destructor(&data[m.offset]);
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        void record_type(offset_t to_add) {
+            const type_id_t type = type_id<U>();
+            const auto it = std::lower_bound(types.begin(), types.end(), type);
+            if (it != types.end() && *it == type)
+                return;
+            const std::uint32_t size = std::is_empty_v<U> ? 0 : sizeof(U);
+            metadata.insert(metadata.begin() + (it - types.begin()), metadata_t{ to_add, 0, size, alignof(U), nullptr, nullptr });
+            types.insert(it, type);
+        }
 
         template<typename T, typename U = rm_cvref_t<T>>
         void record_dtor(const type_id_t& type) {
-            if constexpr (std::is_empty_v<U>)
-                destructors.emplace(type, +[](This& c) {});
+            metadata_t& m = at(type);
+            m.flags |= CONSTRUCTED;
+            present.set(type);
+            if constexpr (std::is_empty_v<U> || std::is_trivially_destructible_v<U>)
+                m.destructor = nullptr;
+            else
+                m.destructor = +[](void* p) { std::destroy_at(static_cast<U*>(p)); };
+            if constexpr (std::is_empty_v<U> || is_trivially_relocatable_v<U>)
+                m.relocate = nullptr;
             else
-                destructors.emplace(type, +[](This& c) { std::destroy_at(&c.get<U>()); });
+                m.relocate = +[](void* from, void* to) {
+                    U* p = std::launder(static_cast<U*>(from));
+                    new(to) U(std::move(*p));
+                    std::destroy_at(p);
+                };
         }
         template<typename T, typename U = rm_cvref_t<T>>
         void record_dtor() { record_dtor<U>(type_id<U>()); }
@@ -286,9 +941,8 @@ namespace heco {
         decltype(auto) insert_1(Args&& ... args) 
         {
             if constexpr (std::is_empty_v<T>) {
-                const auto tid = type_id<T>();
-                record_type(tid, 0);
-                record_dtor<T>(tid);
+                record_type<T>(0);
+                record_dtor<T>();
                 return;
             }
             else {
@@ -308,8 +962,7 @@ namespace heco {
             constexpr size_t N = sizeof...(Ts);
             const type_id_t type_index[N] = { type_id<Ts>()... };
             if constexpr (all_empty) {
-                for (auto ti : type_index)
-                    record_type(ti, 0);
+                (record_type<Ts>(0), ...);
                 size_t i = 0;
                 (record_dtor<Ts>(type_index[i++]), ...);
                 return;
@@ -324,10 +977,11 @@ namespace heco {
         template<typename T, typename... Args>
         decltype(auto) assign_1(Args&& ... args) 
         {
-            if (!is_constructed<T>())
-                return construct_1<T>(offsets[type_id<T>()], std::forward<Args>(args)...);
+            const metadata_t& m = at(type_id<T>());
+            if (!(m.flags & CONSTRUCTED))
+                return construct_1<T>(m.offset, std::forward<Args>(args)...);
             else
-                return do_assign<T>(offsets[type_id<T>()], std::forward<Args>(args)...);
+                return do_assign<T>(m.offset, std::forward<Args>(args)...);
         }
 
         template<typename... Ts>
@@ -357,10 +1011,82 @@ namespace heco {
         void do_destruct()
         {
             assert(contains<T>());
-            const auto type_index = type_id<T>();
-            if constexpr (!std::is_trivially_destructible_v<T>)
-                std::invoke(destructors.at(type_index), *this);
-            destructors.erase(type_index);
+            metadata_t& m = at(type_id<T>());
+            if (m.destructor)
+                m.destructor(&data[m.offset]);
+            m.flags &= ~CONSTRUCTED;
+            present.reset(type_id<T>());
+            m.destructor = nullptr;
+            m.relocate = nullptr;
+            ++generation;
+        }
+
+        template<typename T>
+        void do_erase()
+        {
+            assert(is_allocated<T>());
+            if (is_constructed<T>())
+                do_destruct<T>();
+            const std::size_t i = find(type_id<T>());
+            if (metadata[i].size > 0)
+                file_hole(metadata[i].offset, metadata[i].size);
+            types.erase(types.begin() + i);
+            metadata.erase(metadata.begin() + i);
+            ++generation;
+        }
+
+        //Files the slot freed by erase, merged with the holes right before and after it within the same segment so
+        //that the list never holds more entries than there are objects in between
+        void file_hole(offset_t offset, std::size_t size)
+        {
+            auto same_segment = []([[maybe_unused]] offset_t a, [[maybe_unused]] offset_t b) {
+                if constexpr (Segmented)
+                    return buffer_t::segment_of(a) == buffer_t::segment_of(b);
+                else
+                    return true;
+            };
+            for (std::size_t i = 0; i < holes.size();) {
+                const hole_t hole = holes[i];
+                if (hole.offset + hole.size == offset && same_segment(hole.offset, offset)) {
+                    offset = hole.offset;
+                    size += hole.size;
+                }
+                else if (offset + size == hole.offset && same_segment(offset, hole.offset))
+                    size += hole.size;
+                else {
+                    ++i;
+                    continue;
+                }
+                holes.erase(holes.begin() + i);
+            }
+            insert_hole(offset, size);
+        }
+
+        //Holes are sorted by size, so that the smallest one large enough is found first
+        void insert_hole(offset_t offset, std::size_t size)
+        {
+            const auto it = std::lower_bound(holes.begin(), holes.end(), size, [](const hole_t& hole, std::size_t size) { return hole.size < size; });
+            holes.insert(it, hole_t{ std::uint32_t(size), offset });
+        }
+
+        //Smallest hole freed by erase that holds size bytes once aligned, what is left on either side is filed again
+        std::optional<offset_t> take_hole(std::size_t size, std::size_t alignment)
+        {
+            auto it = std::lower_bound(holes.begin(), holes.end(), size, [](const hole_t& hole, std::size_t size) { return hole.size < size; });
+            for (; it != holes.end(); ++it) {
+                const std::size_t padding = (~std::size_t(it->offset) + 1) & (alignment - 1);
+                if (padding + size > it->size)
+                    continue;
+                const hole_t hole = *it;
+                holes.erase(it);
+                const offset_t output = offset_t(hole.offset + padding);
+                if (padding > 0)
+                    insert_hole(hole.offset, padding);
+                if (padding + size < hole.size)
+                    insert_hole(offset_t(output + size), hole.size - padding - size);
+                return output;
+            }
+            return std::nullopt;
         }
 
         template<typename T, typename U = rm_cvref_t<T>>
@@ -395,6 +1121,49 @@ namespace heco {
                 return do_get<U>(n) = U{ std::forward<Args>(args)... };
         }
 
+        //Move the buffer to a new allocation. Bytes are copied in bulk, then objects which are not trivially relocatable
+        //are move-constructed over their copy and destroyed at their former address.
+        void reallocate(std::size_t capacity)
+        {
+            buffer_t buffer(data.get_allocator());
+            buffer.reserve(capacity);
+            buffer.resize(data.size());
+            transfer(data, buffer);
+            data = std::move(buffer);
+        }
+
+        //Copy the bytes of from into to, which must be as large, then fix the objects that are not trivially relocatable
+        void transfer(buffer_t& from, buffer_t& to) const
+        {
+            if (!from.empty())
+                std::memcpy(to.data(), from.data(), from.size());
+            for (const metadata_t& m : metadata)
+                if (m.relocate && (m.flags & CONSTRUCTED))
+                    m.relocate(&from[m.offset], &to[m.offset]);
+        }
+
+        //Take the buffer of other, whose metadata was already moved in this
+        void take_data(This& other)
+        {
+            if constexpr (InlineCapacity > 0) {
+                if (other.data.is_inline()) {
+                    data.clear();
+                    data.resize(other.data.size());
+                    transfer(other.data, data);
+                    other.data.clear();
+                    return;
+                }
+            }
+            data = std::move(other.data);
+        }
+
+        void grow(std::size_t n)
+        {
+            if (n > data.capacity())
+                reallocate(std::max(n, 2 * data.capacity()));
+            data.resize(n);
+        }
+
         template<typename... Ts>
         auto do_allocate() 
         {
@@ -412,11 +1181,18 @@ namespace heco {
             using namespace std;
             constexpr size_t alignment = alignof(T);
             constexpr size_t size = sizeof(T);
-            const size_t n = data.size();
-            const uintptr_t ptr_end = uintptr_t(data.data() + n);
-            const size_t padding = ((~ptr_end + 1) & (alignment - 1));
-            data.resize(n + padding + size);
-            return array{ offset_t(n + padding) };
+            if (!holes.empty())
+                if (const auto hole = take_hole(size, alignment))
+                    return array{ *hole };
+            if constexpr (Segmented)
+                return data.template allocate<1>({ alignment }, { size });
+            else {
+                const size_t n = data.size();
+                const uintptr_t ptr_end = uintptr_t(data.data() + n);
+                const size_t padding = ((~ptr_end + 1) & (alignment - 1));
+                grow(n + padding + size);
+                return array{ offset_t(n + padding) };
+            }
         }
 
         template<typename... Ts>
@@ -425,43 +1201,68 @@ namespace heco {
             using namespace std;
 
             constexpr size_t N = sizeof...(Ts);
-            array<offset_t, N> output;
-            size_t to_allocate = 0;
-
-            const size_t size_before = data.size();
-            uintptr_t ptr_end = uintptr_t(data.data() + size_before);
-
             constexpr array<size_t, N> alignments = { alignof(Ts)... };
             constexpr array<size_t, N> sizes = { sizeof(Ts)... };
-            array<size_t, N> paddings = {};
-            array<size_t, N> min_paddings = {};
-            size_t n_min = 0;
-
-            vector_fixed_capacity<size_t, N> indices;
-            indices.resize(N);
-            iota(indices.begin(), indices.end(), 0);
-            //^ Fill container with indices to visit [0,1,...,N-1]
-            while (!indices.empty())
-            {
-                for_each(begin(indices), end(indices), [&](auto i) { paddings[i] = ((~ptr_end + 1) & (alignments[i] - 1)); });
-                //^ Fill current padding for all remaining types to allocate for
-                size_t min_padding = paddings[*min_element(begin(indices), end(indices), [&](auto i, auto j) {return paddings[i] < paddings[j]; })];
-                //^ Get value of minimum padding
-                n_min = 0;
-                for (auto id : indices) {
-                    if (paddings[id] == min_padding)
-                        min_paddings[n_min++] = id;//< Store index of all arguments with same padding value
+            if (!holes.empty())
+                return do_allocate_holes(alignments, sizes);
+            if constexpr (Segmented)
+                return data.template allocate<Ts...>();
+            else {
+                const size_t size_before = data.size();
+                const auto& layout = packing_table<Ts...>::at(uintptr_t(data.data() + size_before));
+                array<offset_t, N> output;
+                for (size_t i = 0; i < N; ++i)
+                    output[i] = offset_t(size_before + layout.offsets[i]);
+                grow(size_before + layout.size);
+                return output;
+            }
+        }
+
+        //Bulk allocation taking first the holes matching some of the types, the others are packed after the end
+        template<std::size_t N>
+        auto do_allocate_holes(std::array<std::size_t, N> alignments, std::array<std::size_t, N> sizes) ->std::array<offset_t, N>
+        {
+            std::array<offset_t, N> output;
+            std::array<bool, N> from_hole = {};
+            bool any_left = false;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (const auto hole = take_hole(sizes[i], alignments[i])) {
+                    output[i] = *hole;
+                    from_hole[i] = true;
+                    alignments[i] = 1;
+                    sizes[i] = 0;
                 }
-                size_t id_element = *max_element(begin(min_paddings), begin(min_paddings) + n_min, [&](auto i, auto j) {return sizes[i] < sizes[j]; });
-                //^ Get index of type to store that has maximum size for the minimum padding
-                output[id_element] = size_before + to_allocate + min_padding;
-                to_allocate += min_padding + sizes[id_element];
-                ptr_end += min_padding + sizes[id_element];
-                indices.erase(find(begin(indices), end(indices), id_element));
+                else
+                    any_left = true;
             }
-            size_t size_after = size_before + to_allocate;
-            data.resize(size_after);
+            if (!any_left)
+                return output;
+            std::array<offset_t, N> packed;
+            if constexpr (Segmented)
+                packed = data.template allocate<N>(alignments, sizes);
+            else {
+                const std::size_t size_before = data.size();
+                const auto layout = pack(alignments, sizes, std::uintptr_t(data.data() + size_before));
+                for (std::size_t i = 0; i < N; ++i)
+                    packed[i] = offset_t(size_before + layout.offsets[i]);
+                grow(size_before + layout.size);
+            }
+            for (std::size_t i = 0; i < N; ++i)
+                if (!from_hole[i])
+                    output[i] = packed[i];
             return output;
         }
     };
-}
\ No newline at end of file
+
+    using HeterogeneousArray = BasicHeterogeneousArray<false>;
+    using HeterogeneousArray_Segmented = BasicHeterogeneousArray<true>;
+    template<std::size_t InlineCapacity>
+    using HeterogeneousArray_Small = BasicHeterogeneousArray<false, InlineCapacity>;
+}
+
+namespace std {
+    template<typename Container, typename... Ts>
+    struct tuple_size<heco::ArrayView<Container, Ts...>> : integral_constant<size_t, sizeof...(Ts)> {};
+    template<size_t I, typename Container, typename... Ts>
+    struct tuple_element<I, heco::ArrayView<Container, Ts...>> { using type = tuple_element_t<I, tuple<Ts...>>&; };
+}
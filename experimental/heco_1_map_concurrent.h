@@ -0,0 +1,188 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "heco_type_registry.h"
+
+namespace heco
+{
+    //HeterogeneousContainer which threads may use at the same time. Slots are indexed by type id in pages allocated
+    //on first use, like the sparse side of HeterogeneousContainer_SparseSet, and both pages and objects are published
+    //once with a compare-and-swap. An object never moves nor goes away before the container does, so get and has are
+    //two acquire loads without any lock, and concurrent insertions of the same type agree on a single object.
+    //Assigning or erasing would race with readers, this container does neither.
+    class HeterogeneousContainer_Concurrent
+    {
+    private:
+        template<typename T>
+        using rm_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;//remove_cvref_t from C++20 only
+
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, HeterogeneousContainer_Concurrent>(); }
+
+    public:
+        static constexpr std::size_t page_size = 128;
+        static constexpr std::size_t max_pages = 64;
+        static constexpr std::size_t max_types = page_size * max_pages;
+
+        HeterogeneousContainer_Concurrent() = default;
+        //Objects and pages are allocated from resource, which must be thread-safe itself
+        explicit HeterogeneousContainer_Concurrent(std::pmr::memory_resource* resource) : memory(resource) {}
+        HeterogeneousContainer_Concurrent(const HeterogeneousContainer_Concurrent&) = delete;
+        HeterogeneousContainer_Concurrent& operator=(const HeterogeneousContainer_Concurrent&) = delete;
+        ~HeterogeneousContainer_Concurrent()
+        {
+            for (std::atomic<page*>& p : pages) {
+                page* current = p.load(std::memory_order_acquire);
+                if (!current)
+                    continue;
+                for (std::atomic<entry*>& slot : current->slots)
+                    if (entry* e = slot.load(std::memory_order_acquire))
+                        e->destroy(e, memory);
+                memory->deallocate(current, sizeof(page), alignof(page));
+            }
+        }
+
+        //Header of every object, knows how to destroy it
+        struct entry {
+            void(*destroy)(entry* self, std::pmr::memory_resource* resource);
+        };
+        template<typename U>
+        struct node : entry {
+            U value;
+        };
+        struct page {
+            std::atomic<entry*> slots[page_size];
+        };
+
+        std::atomic<page*> pages[max_pages] = {};
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource();
+
+        std::pmr::memory_resource* resource() const noexcept { return memory; }
+
+        template<typename... Ts>
+        bool contains() const noexcept { return ((find(type_id<Ts>()) != nullptr) && ...); }
+
+        template<typename T>
+        auto has() const noexcept
+        {
+            using U = std::remove_reference_t<T>;
+            entry* e = find(type_id<U>());
+            return e ? static_cast<U*>(&static_cast<node<rm_cvref_t<U>>*>(e)->value) : nullptr;
+        }
+
+        template<typename T, typename... Rest>
+        decltype(auto) get() const noexcept
+        {
+            if constexpr (sizeof...(Rest) == 0) {
+                using U = std::remove_reference_t<T>;
+                U* p = has<U>();
+                assert(p);
+                return *p;
+            }
+            else
+                return std::forward_as_tuple(get<T>(), get<Rest>()...);
+        }
+
+        template<typename T>
+        static constexpr bool must_be_copyable_if_lvalue = std::is_lvalue_reference_v<T> && std::is_copy_constructible_v<T>;
+        template<typename T>
+        static constexpr bool must_be_moveable_if_rvalue = (std::is_object_v<T> || std::is_rvalue_reference_v<T>) && std::is_move_constructible_v<T>;
+
+        //Insert the objects of types not held yet. The object returned for a type already held, or published first by
+        //another thread, is the one in the container, in which case args are only used if construction was started.
+        template<typename T = void, typename... Args>
+        auto insert(Args&& ... args) -> decltype(auto)
+        {
+            if constexpr (std::is_same_v<T, void>)
+                static_assert(((must_be_copyable_if_lvalue<Args> || must_be_moveable_if_rvalue<Args>) && ...), "Use in-place version insert<T>(Args...) instead");
+
+            if constexpr (!std::is_same_v<T, void>)
+                return insert_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return insert_1<Args...>(std::forward<Args>(args)...);
+            else
+                return std::forward_as_tuple(insert_1<Args>(std::forward<Args>(args))...);
+        }
+
+    private:
+        entry* find(type_id_t id) const noexcept
+        {
+            if (id >= max_types)
+                return nullptr;
+            const page* p = pages[id / page_size].load(std::memory_order_acquire);
+            return p ? p->slots[id % page_size].load(std::memory_order_acquire) : nullptr;
+        }
+
+        //Slot of the type, publishing its page if no thread did yet. Throws std::length_error for an id past the
+        //directory of pages, which ids numbered by the process-wide registry may reach.
+        std::atomic<entry*>& slot(type_id_t id)
+        {
+            if (id >= max_types)
+                throw std::length_error("heco::HeterogeneousContainer_Concurrent: too many types");
+            std::atomic<page*>& p = pages[id / page_size];
+            page* current = p.load(std::memory_order_acquire);
+            if (!current) {
+                page* created = new(memory->allocate(sizeof(page), alignof(page))) page{};
+                if (p.compare_exchange_strong(current, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                    current = created;
+                else
+                    memory->deallocate(created, sizeof(page), alignof(page));
+            }
+            return current->slots[id % page_size];
+        }
+
+        template<typename T, typename... Args>
+        auto insert_1(Args&& ... args) -> rm_cvref_t<T>&
+        {
+            using U = rm_cvref_t<T>;
+            std::atomic<entry*>& s = slot(type_id<U>());
+            entry* published = s.load(std::memory_order_acquire);
+            if (!published) {
+                entry* created = make<U>(std::forward<Args>(args)...);
+                if (s.compare_exchange_strong(published, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                    published = created;
+                else
+                    created->destroy(created, memory);
+            }
+            return static_cast<node<U>*>(published)->value;
+        }
+
+        template<typename U, typename... Args>
+        entry* make(Args&& ... args)
+        {
+            void* p = memory->allocate(sizeof(node<U>), alignof(node<U>));
+            return new(p) node<U>{ { +[](entry* self, std::pmr::memory_resource* resource) {
+                std::destroy_at(static_cast<node<U>*>(self));
+                resource->deallocate(self, sizeof(node<U>), alignof(node<U>));
+            } }, U{ std::forward<Args>(args)... } };
+        }
+    };
+}
@@ -19,13 +19,21 @@
 // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
+#include <array>          // for array
 #include <cstddef>        // for size_t
 #include <cstdint>        // for std::uint32_t
 #include <memory>         // for unique_ptr
+#include <memory_resource> // for pmr::memory_resource
 #include <tuple>          // for forward_as_tuple
 #include <type_traits>    // for remove_reference_t, remove_cv_t
 #include <unordered_map>  // for unordered_map
 #include <utility>        // for forward
+#include "heco_frozen.h"
+#include "heco_packing.h"
+#include "heco_reclaim_queue.h"
+#include "heco_slab_pool.h"
+#include "heco_type_registry.h"
+#include "heco_type_set.h"
 
 namespace heco
 {
@@ -37,27 +45,65 @@ namespace heco
 
         using type_id_t = std::uint32_t;
 
-        class TypeCounter {
-            static inline type_id_t i = 0;
-        public:
-            template<typename T>
-            static inline const auto id = i++;
-        };
-        template<typename T> static inline auto type_id() { return TypeCounter::id<rm_cvref_t<T>>; }
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, HeterogeneousContainer>(); }
 
     public:
         HeterogeneousContainer() = default;
+        //Objects and map nodes are allocated from resource
+        explicit HeterogeneousContainer(std::pmr::memory_resource* resource) : data(resource) {}
+        //Objects are allocated from the slab pool of their type, shared by all pooled containers, tables from resource
+        explicit HeterogeneousContainer(pooled_t, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : data(resource), pooled(true) {}
+        //Objects are allocated from resource and destroyed by queue once the container is, see reclaim_queue: resource
+        //must be thread-safe when the queue runs a thread of its own, which this does not check
+        explicit HeterogeneousContainer(deferred_t, reclaim_queue& queue, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : data(resource), reclaim(&queue) {}
         HeterogeneousContainer(const HeterogeneousContainer&) = delete;
         HeterogeneousContainer& operator=(const HeterogeneousContainer&) = delete;
-        HeterogeneousContainer(HeterogeneousContainer&&) = default;
-        HeterogeneousContainer& operator=(HeterogeneousContainer&&) = default;
-        ~HeterogeneousContainer() = default;
+        HeterogeneousContainer(HeterogeneousContainer&& other) noexcept
+            : data(std::move(other.data)), pooled(other.pooled), present(std::exchange(other.present, type_set{})), reclaim(other.reclaim) {}
+        HeterogeneousContainer& operator=(HeterogeneousContainer&& other) {
+            if (this != &other) {
+                if (reclaim)
+                    retire();
+                data = std::move(other.data);
+                other.data.clear();
+                pooled = other.pooled;
+                present = std::exchange(other.present, type_set{});
+                reclaim = other.reclaim;
+            }
+            return *this;
+        }
+        ~HeterogeneousContainer() {
+            if (reclaim)
+                retire();
+        }
+
+        using deleter = object_deleter;
+        using ptr_dtor = object_ptr;
+        std::pmr::unordered_map<type_id_t, ptr_dtor> data;
 
-        using ptr_dtor = std::unique_ptr<void,void(*)(void*)>;
-        std::unordered_map<type_id_t, ptr_dtor> data;
+        bool pooled = false;
+        type_set present;//< keys of data
+        reclaim_queue* reclaim = nullptr;//< destroys the objects in deferred mode
+
+        std::pmr::memory_resource* resource() const noexcept { return data.get_allocator().resource(); }
+
+        template<typename... Ts>
+        bool contains() const noexcept {
+            const type_mask& m = mask<Ts...>();
+            return m.exact ? present.includes(m.bits) : (data.count(type_id<Ts>()) && ...);
+        }
 
+        //Types held by the container, to be tested against mask<Ts...>()
+        const type_set& presence() const noexcept { return present; }
         template<typename... Ts>
-        bool contains() const noexcept { return (data.count(type_id<Ts>()) && ...);}
+        static const type_mask& mask() {
+            static const type_mask m = type_mask::of(type_id<Ts>()...);
+            return m;
+        }
+
+        //Hand the objects over to a read-only container indexed by a perfect hash, for threads to share once filled.
+        //Objects do not move, references obtained before stay valid.
+        Frozen<HeterogeneousContainer> freeze() && { return Frozen<HeterogeneousContainer>(std::move(*this)); }
 
         template<typename...Ts>
         void reserve() { reserve(sizeof...(Ts)); }
@@ -75,6 +121,11 @@ namespace heco
                 return std::forward_as_tuple(has<T>(), has<Rest>()...);
         }
 
+        //Hint the cache to load the objects of Ts... ahead of get<Ts...>(), e.g. for the container processed a few
+        //iterations later. Finding their address walks the map, the objects themselves are not read.
+        template<typename... Ts>
+        void prefetch() const noexcept { (prefetch_1(type_id<Ts>()), ...); }
+
         template<typename T, typename... Rest>
         auto get() noexcept -> decltype(auto)
         {
@@ -122,6 +173,34 @@ namespace heco
         }
 
     private:
+        template<typename, typename> friend class Frozen;
+
+        void prefetch_1(type_id_t id) const noexcept
+        {
+            const auto it = data.find(id);
+            if (it != data.end())
+                HECO_PREFETCH(it->second.get());
+        }
+
+        //Hand the objects over to the reclaim queue, which destroys them later, and leave the container empty
+        void retire()
+        {
+            if (data.empty())
+                return;
+            reclaim_queue* queue = std::exchange(reclaim, nullptr);
+            queue->retire(HeterogeneousContainer(std::move(*this)));
+            data.clear();
+            reclaim = queue;
+        }
+
+        //Calls f(id, address) for every object
+        template<typename F>
+        void visit_objects(F&& f) const
+        {
+            for (const auto& [id, ptr] : data)
+                f(id, ptr.get());
+        }
+
         template<typename T>
         static constexpr bool copyable_if_lvalue = std::is_lvalue_reference_v<T> && std::is_copy_constructible_v<T>;
         template<typename T>
@@ -130,30 +209,39 @@ namespace heco
         template<typename T, typename... Args>
          auto insert_1(Args&&... args) -> decltype(auto)
         {
-            using U = rm_cvref_t<T>;
-            auto&&[it, in] = data.emplace(
-                type_id<T>(),
-                std::unique_ptr<void, void (*)(void*)>{ new U{ std::forward<Args>(args)... },
-                                                        +[](void* instance) { delete static_cast<U*>(instance); } });
-            return *static_cast<U*>(it->second.get());
+            return put<T>(make_object<rm_cvref_t<T>>(pooled, resource(), std::forward<Args>(args)...));
         }
 
          template<typename... Ts>
          auto insert_n(Ts&&... values) -> decltype(auto)
          {
              data.reserve(data.size() + sizeof...(Ts));
-             return std::forward_as_tuple(insert_1<Ts>(std::forward<Ts>(values))...);
+             if (pooled)
+                 return std::forward_as_tuple(insert_1<Ts>(std::forward<Ts>(values))...);
+             return put_n<Ts...>(std::index_sequence_for<Ts...>{}, make_objects(resource(), std::forward<Ts>(values)...));
          }
 
+        //Hand the objects made by make_objects over to the container, in the order of Ts...
+        template<typename... Ts, std::size_t... I>
+        auto put_n(std::index_sequence<I...>, std::array<ptr_dtor, sizeof...(Ts)>&& objects) -> std::tuple<rm_cvref_t<Ts>&...>
+        {
+            return { put<Ts>(std::move(objects[I]))... };
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        U& put(ptr_dtor&& ptr)
+        {
+            auto&&[it, in] = data.emplace(type_id<T>(), std::move(ptr));
+            present.set(type_id<T>());
+            return *static_cast<U*>(it->second.get());
+        }
+
         template<typename T, typename... Args>
         auto insert_or_assign_1(Args&& ... args) -> decltype(auto)
         {
             using U = rm_cvref_t<T>;
-            auto&&[it,in] = data.insert_or_assign(
-                type_id<T>(),
-                std::unique_ptr<void, void(*)(void*)>{ new U{ std::forward<Args>(args)... },
-                                                       +[](void* instance) { delete static_cast<U*>(instance); } }
-            );
+            auto&&[it,in] = data.insert_or_assign(type_id<T>(), make_object<U>(pooled, resource(), std::forward<Args>(args)...));
+            present.set(type_id<T>());
             return *static_cast<U*>(it->second.get());
         }
     };
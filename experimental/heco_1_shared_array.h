@@ -0,0 +1,520 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include "heco_1_map_array.h"
+
+namespace heco {
+
+    //Immutable description of the types held by a HeterogeneousArray_Shared: where each type is stored and which ones
+    //are constructed. Layouts are interned and reference counted, containers going through the same sequence of
+    //insertions from an empty state point to the same Layout, in the manner of hidden classes.
+    class Layout
+    {
+    public:
+        using offset_t = std::uint32_t;
+        using destructor_t = void(*)(void*);
+        using relocator_t = void(*)(void* from, void* to);
+
+        map<type_id_t, offset_t> offsets;
+        map<type_id_t, destructor_t> destructors;//< nullptr for types without anything to destroy
+        map<type_id_t, relocator_t> relocators;//< constructed types whose bytes cannot simply be copied to move them
+        type_set constructed;//< keys of destructors
+        std::size_t size = 0;
+
+        Layout(const Layout&) = delete;
+        Layout& operator=(const Layout&) = delete;
+
+        static Layout* empty() { static Layout* root = new Layout; return root; }
+
+        //Each transition consumes the reference held on `from` and returns a reference on the resulting layout
+        static Layout* allocate(Layout* from, type_id_t type, offset_t offset, std::size_t bytes)
+        {
+            return transition(from, ALLOCATE, (std::uint64_t(type) << 32) | offset, [&](Layout& to) {
+                to.offsets.emplace(type, offset);
+                to.size = std::max(to.size, offset + bytes);
+            });
+        }
+
+        static Layout* construct(Layout* from, type_id_t type, destructor_t destructor, relocator_t relocate)
+        {
+            return transition(from, CONSTRUCT, type, [&](Layout& to) {
+                to.destructors.emplace(type, destructor);
+                if (relocate)
+                    to.relocators.emplace(type, relocate);
+                to.constructed.set(type);
+            });
+        }
+
+        static Layout* destruct(Layout* from, type_id_t type)
+        {
+            return transition(from, DESTRUCT, type, [&](Layout& to) {
+                to.destructors.erase(type);
+                to.relocators.erase(type);
+                to.constructed.reset(type);
+            });
+        }
+
+        static void release(Layout* layout)
+        {
+            if (layout == empty() || layout->refcount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            std::lock_guard<std::mutex> guard(mutex());
+            destroy_locked(layout);
+        }
+
+        std::size_t use_count() const { return refcount.load(std::memory_order_relaxed); }
+
+    private:
+        enum kind : std::uint8_t { ALLOCATE, CONSTRUCT, DESTRUCT };
+
+        Layout() = default;
+
+        //The tree of transitions is read without the lock, hence the atomics. Layouts are recycled but never deleted,
+        //so that a reader standing on a layout destroyed meanwhile still reads a Layout.
+        std::atomic<Layout*> parent{ nullptr };
+        std::atomic<kind> parent_kind{ ALLOCATE };
+        std::atomic<std::uint64_t> parent_key{ 0 };
+        std::atomic<Layout*> children{ nullptr };//< last layout transitioned to from this one
+        std::atomic<Layout*> sibling{ nullptr };//< previous layout transitioned to from the same parent
+        std::atomic<std::size_t> refcount{ 0 };//< containers using it + layouts transitioning from it
+        Layout* next_free = nullptr;
+
+        //Only serializes the creation and the destruction of layouts, following an existing transition is lock-free
+        static std::mutex& mutex() { static std::mutex* m = new std::mutex; return *m; }
+        static Layout*& free_list() { static Layout* head = nullptr; return head; }
+
+        //Take a reference on a layout unless it is being destroyed
+        static bool acquire(Layout* layout)
+        {
+            std::size_t n = layout->refcount.load(std::memory_order_relaxed);
+            while (n != 0)
+                if (layout->refcount.compare_exchange_weak(n, n + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+            return false;
+        }
+
+        bool is_transition(const Layout* from, kind k, std::uint64_t key) const
+        {
+            return parent.load(std::memory_order_relaxed) == from && parent_kind.load(std::memory_order_relaxed) == k
+                && parent_key.load(std::memory_order_relaxed) == key;
+        }
+
+        //Layout reached from this one by the transition, without taking a reference. Exact with the lock held only.
+        Layout* transition_to(kind k, std::uint64_t key) const
+        {
+            for (Layout* n = children.load(std::memory_order_acquire); n; n = n->sibling.load(std::memory_order_acquire))
+                if (n->is_transition(this, k, key))
+                    return n;
+            return nullptr;
+        }
+
+        //Lock-free path, returns a reference on the layout reached or nullptr to take the lock. A layout met on the
+        //way may have been recycled meanwhile, it is only trusted once a reference is held on it.
+        static Layout* follow(Layout* from, kind k, std::uint64_t key)
+        {
+            for (Layout* n = from->children.load(std::memory_order_acquire); n; n = n->sibling.load(std::memory_order_acquire)) {
+                if (n->parent.load(std::memory_order_relaxed) != from)
+                    return nullptr;
+                if (!n->is_transition(from, k, key))
+                    continue;
+                if (!acquire(n))
+                    return nullptr;
+                if (n->is_transition(from, k, key))
+                    return n;
+                release(n);
+                return nullptr;
+            }
+            return nullptr;
+        }
+
+        template<typename F>
+        static Layout* transition(Layout* from, kind k, std::uint64_t key, F&& make)
+        {
+            Layout* to = follow(from, k, key);
+            if (!to) {
+                std::lock_guard<std::mutex> guard(mutex());
+                to = from->transition_to(k, key);
+                //a layout found without any reference left is being destroyed, another one takes its place
+                if (!to || !acquire(to)) {
+                    to = free_list() ? std::exchange(free_list(), free_list()->next_free) : new Layout;
+                    to->offsets = from->offsets;
+                    to->destructors = from->destructors;
+                    to->relocators = from->relocators;
+                    to->constructed = from->constructed;
+                    to->size = from->size;
+                    make(*to);
+                    to->parent.store(from, std::memory_order_relaxed);
+                    to->parent_kind.store(k, std::memory_order_relaxed);
+                    to->parent_key.store(key, std::memory_order_relaxed);
+                    to->sibling.store(from->children.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    to->refcount.store(1, std::memory_order_release);
+                    from->refcount.fetch_add(1, std::memory_order_relaxed);
+                    from->children.store(to, std::memory_order_release);
+                }
+            }
+            release(from);
+            return to;
+        }
+
+        //Recycle a layout whose last reference was released, then its ancestors left unused. Called with the lock held.
+        static void destroy_locked(Layout* layout)
+        {
+            while (true) {
+                Layout* parent = layout->parent.load(std::memory_order_relaxed);
+                std::atomic<Layout*>* link = &parent->children;
+                while (link->load(std::memory_order_relaxed) != layout)
+                    link = &link->load(std::memory_order_relaxed)->sibling;
+                //sibling is left as is, for the readers standing on the layout to go on
+                link->store(layout->sibling.load(std::memory_order_relaxed), std::memory_order_release);
+                layout->offsets.clear();
+                layout->destructors.clear();
+                layout->relocators.clear();
+                layout->constructed.clear();
+                layout->size = 0;
+                layout->next_free = std::exchange(free_list(), layout);
+                if (parent == empty() || parent->refcount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    return;
+                layout = parent;
+            }
+        }
+    };
+
+    //HeterogeneousArray where the type to offset table and the destructors are stored in a shared Layout, an instance
+    //only owns a pointer to its layout and its bytes
+    class HeterogeneousArray_Shared
+    {
+    public:
+        using This = HeterogeneousArray_Shared;
+        using offset_t = Layout::offset_t;
+
+        HeterogeneousArray_Shared() = default;
+        //Only the objects come from resource, layouts are shared between containers and stay on the heap
+        explicit HeterogeneousArray_Shared(std::pmr::memory_resource* resource) : data(resource) {}
+        HeterogeneousArray_Shared(const HeterogeneousArray_Shared&) = delete;
+        HeterogeneousArray_Shared& operator=(const HeterogeneousArray_Shared&) = delete;
+        HeterogeneousArray_Shared(HeterogeneousArray_Shared&& other) noexcept
+            : layout(std::exchange(other.layout, Layout::empty()))
+            , data(std::move(other.data))
+        {
+            other.data.clear();
+        }
+        HeterogeneousArray_Shared& operator=(HeterogeneousArray_Shared&& other) noexcept {
+            if (this != &other) {
+                clear();
+                std::swap(layout, other.layout);
+                data = std::move(other.data);
+                other.data.clear();
+            }
+            return *this;
+        }
+        ~HeterogeneousArray_Shared() {
+            destroy_all();
+            Layout::release(layout);
+        }
+
+    private:
+        Layout* layout = Layout::empty();
+        mutable std::vector<std::byte, resource_allocator<std::byte, default_alignment>> data;
+
+    public:
+        const Layout* shared_layout() const { return layout; }
+
+        bool is_allocated(const type_id_t& type) const { return layout->offsets.count(type); }
+        template<typename T>
+        bool is_allocated() const { return is_allocated(type_id<T>()); }
+
+        bool is_constructed(const type_id_t& type) const { return layout->destructors.count(type); }
+        template<typename T>
+        bool is_constructed() const { return is_constructed(type_id<T>()); }
+
+        bool contains(const type_id_t& type) const { return type_set::representable(type) ? layout->constructed.test(type) : is_constructed(type); }
+        template<typename... Ts>
+        bool contains() const {
+            const type_mask& m = mask<Ts...>();
+            return m.exact ? layout->constructed.includes(m.bits) : (contains(type_id<Ts>()) && ...);
+        }
+
+        //Types constructed in the container, held by its layout
+        const type_set& presence() const noexcept { return layout->constructed; }
+        template<typename... Ts>
+        static const type_mask& mask() { return mask_of<Ts...>(); }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        auto has() const {
+            const type_id_t tid = type_id<U>();
+            if constexpr (std::is_empty_v<U>)
+                return contains(tid);
+            else
+                return contains(tid) ? &do_get<U>(layout->offsets.at(tid)) : (U*)nullptr;
+        }
+
+        template<typename T, typename... Rest>
+        auto offset_of() const
+        {
+            return array{ layout->offsets.at(type_id<T>()), layout->offsets.at(type_id<Rest>())... };
+        }
+
+        template<typename... Ts>
+        decltype(auto) get() const
+        {
+            static_assert(sizeof...(Ts) > 0);
+            const Layout& l = *layout;
+            if constexpr (sizeof...(Ts) == 1)
+                return (do_get<Ts>(l.offsets.at(type_id<Ts>())), ...);
+            else
+                return std::forward_as_tuple(do_get<Ts>(l.offsets.at(type_id<Ts>()))...);
+        }
+
+        template<typename... Ts>
+        auto reserve()
+        {
+            assert((!is_allocated<Ts>() && ...));
+            const auto offsets = do_allocate<Ts...>();
+            if constexpr (sizeof...(Ts) == 1)
+                return offsets[0];
+            else
+                return offsets;
+        }
+
+        void reserve(size_t n_bytes)
+        {
+            if (n_bytes > data.capacity())
+                reallocate(n_bytes);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) construct(Args&& ... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return construct_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (construct_1<Args>(std::forward<Args>(args)), ...);
+            else
+                return std::tuple<rm_cvref_t<Args>&...>{construct_1<Args>(std::forward<Args>(args))...};
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) insert(Args&& ... args)
+        {
+            if constexpr (std::is_same_v<T, void>)
+                static_assert(((must_be_copyable_if_lvalue<Args> || must_be_moveable_if_rvalue<Args>) && ...), "Use in-place version insert<T>(Args...) instead");
+
+            if constexpr (!std::is_same_v<T, void>)
+                return insert_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (insert_1<Args>(std::forward<Args>(args)), ...);
+            else
+                return insert_n(std::forward<Args>(args)...);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) assign(Args&&... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return assign_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (assign_1<Args>(std::forward<Args>(args)), ...);
+            else
+                return std::tuple<rm_cvref_t<Args>&...>{assign_1<Args>(std::forward<Args>(args))...};
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) insert_or_assign(Args&& ... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return insert_or_assign_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (insert_or_assign_1<Args>(std::forward<Args>(args)), ...);
+            else
+                return std::tuple<rm_cvref_t<Args>& ...>{insert_or_assign_1<Args>(std::forward<Args>(args))...};
+        }
+
+        template<typename... Ts>
+        void destruct() {
+            (do_destruct<Ts>(), ...);
+        }
+
+        void clear()
+        {
+            destroy_all();
+            Layout::release(std::exchange(layout, Layout::empty()));
+            data.clear();
+        }
+
+    private:
+        template<typename T>
+        static constexpr bool must_be_copyable_if_lvalue = std::is_lvalue_reference_v<T> && std::is_copy_constructible_v<T>;
+        template<typename T>
+        static constexpr bool must_be_moveable_if_rvalue = (std::is_object_v<T> || std::is_rvalue_reference_v<T>) && std::is_move_constructible_v<T>;
+
+        void destroy_all()
+        {
+            for (auto [tid, destructor] : layout->destructors)
+                if (destructor)
+                    destructor(&data[layout->offsets.at(tid)]);
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        static constexpr Layout::destructor_t destructor_of()
+        {
+            if constexpr (std::is_empty_v<U> || std::is_trivially_destructible_v<U>)
+                return nullptr;
+            else
+                return +[](void* p) { std::destroy_at(static_cast<U*>(p)); };
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        static constexpr Layout::relocator_t relocator_of()
+        {
+            if constexpr (std::is_empty_v<U> || is_trivially_relocatable_v<U>)
+                return nullptr;
+            else
+                return +[](void* from, void* to) {
+                    U* p = std::launder(static_cast<U*>(from));
+                    new(to) U(std::move(*p));
+                    std::destroy_at(p);
+                };
+        }
+
+        template<typename T, typename... Args, typename U = rm_cvref_t<T>>
+        decltype(auto) construct_1(Args&& ... args)
+        {
+            assert(!is_constructed<U>());
+            const offset_t offset = layout->offsets.at(type_id<U>());
+            layout = Layout::construct(layout, type_id<U>(), destructor_of<U>(), relocator_of<U>());
+            if constexpr (std::is_empty_v<U>)
+                return;
+            else
+                return *new(&data[offset]) U{ std::forward<Args>(args)... };
+        }
+
+        template<typename T, typename... Args, typename U = rm_cvref_t<T>>
+        decltype(auto) insert_1(Args&& ... args)
+        {
+            if constexpr (std::is_empty_v<U>) {
+                if (!is_allocated<U>())
+                    layout = Layout::allocate(layout, type_id<U>(), 0, 0);
+                if (!is_constructed<U>())
+                    layout = Layout::construct(layout, type_id<U>(), nullptr, nullptr);
+                return;
+            }
+            else {
+                assert(!contains<U>());
+                reserve<U>();
+                return construct_1<U>(std::forward<Args>(args)...);
+            }
+        }
+
+        template<typename... Ts>
+        decltype(auto) insert_n(Ts&& ... values)
+        {
+            constexpr bool all_empty = (std::is_empty_v<rm_cvref_t<Ts>> && ...);
+            constexpr bool none_empty = (!std::is_empty_v<rm_cvref_t<Ts>> && ...);
+            static_assert(all_empty || none_empty, "Cannot insert a mix of empty and non-empty types.");
+            if constexpr (all_empty)
+                (insert_1<Ts>(std::forward<Ts>(values)), ...);
+            else {
+                assert((!contains<Ts>() && ...));
+                reserve<rm_cvref_t<Ts>...>();
+                return std::tuple<rm_cvref_t<Ts>&...>{construct_1<Ts>(std::forward<Ts>(values))...};
+            }
+        }
+
+        template<typename T, typename... Args, typename U = rm_cvref_t<T>>
+        decltype(auto) assign_1(Args&& ... args)
+        {
+            if (!is_constructed<U>())
+                return construct_1<U>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1 && (std::is_same_v<U, rm_cvref_t<Args>> && ...))
+                return get<U>() = (std::forward<Args>(args), ...);
+            else
+                return get<U>() = U{ std::forward<Args>(args)... };
+        }
+
+        template<typename T, typename... Args>
+        decltype(auto) insert_or_assign_1(Args&& ... args)
+        {
+            if (!is_allocated<T>())
+                return insert<T>(std::forward<Args>(args)...);
+            else
+                return assign<T>(std::forward<Args>(args)...);
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        void do_destruct()
+        {
+            assert(contains<U>());
+            if (auto destructor = layout->destructors.at(type_id<U>()))
+                destructor(&data[layout->offsets.at(type_id<U>())]);
+            layout = Layout::destruct(layout, type_id<U>());
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        T& do_get(offset_t n) const noexcept
+        {
+            static_assert(!std::is_empty_v<U>);
+            return *std::launder(reinterpret_cast<U*>(&data[n]));
+        }
+
+        //Same packing as HeterogeneousArray, computed from the layout size only so that every container following the
+        //same insertions reaches the same offsets
+        template<typename... Ts>
+        auto do_allocate() -> std::array<offset_t, sizeof...(Ts)>
+        {
+            static_assert(((alignof(Ts) <= default_alignment) && ...));
+            static_assert(all_types_different<rm_cvref_t<Ts>...>);
+            constexpr std::size_t N = sizeof...(Ts);
+            const std::size_t size_before = layout->size;
+            const auto packed = pack<N>({ alignof(Ts)... }, { sizeof(Ts)... }, size_before);
+            std::array<offset_t, N> output;
+            std::size_t i = 0;
+            ((output[i] = offset_t(size_before + packed.offsets[i]), layout = Layout::allocate(layout, type_id<Ts>(), output[i], sizeof(Ts)), ++i), ...);
+            grow(layout->size);
+            return output;
+        }
+
+        //Move the bytes to a new allocation, then move-construct the objects which are not trivially relocatable over
+        //their copy and destroy them at their former address, as HeterogeneousArray does
+        void reallocate(std::size_t capacity)
+        {
+            decltype(data) buffer(data.get_allocator());
+            buffer.reserve(capacity);
+            buffer.resize(data.size());
+            if (!data.empty())
+                std::memcpy(buffer.data(), data.data(), data.size());
+            for (auto [tid, relocate] : layout->relocators)
+                relocate(&data[layout->offsets.at(tid)], &buffer[layout->offsets.at(tid)]);
+            data = std::move(buffer);
+        }
+
+        void grow(std::size_t n)
+        {
+            if (n > data.capacity())
+                reallocate(std::max(n, 2 * data.capacity()));
+            data.resize(n);
+        }
+    };
+}
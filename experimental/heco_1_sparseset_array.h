@@ -0,0 +1,357 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "heco_1_map_array.h"
+#include "heco_local_slots.h"
+#include "heco_type_set.h"
+
+namespace heco
+{
+    //Sparse set whose dense side is a single byte buffer in which objects are packed as in HeterogeneousArray. Getting
+    //an object is sparse[type] then offsets[position], without going through a pointer to a separate allocation.
+    //Objects move when the buffer grows, which also drops the bytes left by erase, see HeterogeneousArray for how
+    //objects are relocated.
+    //With Local, the sparse side is a local_slots table sized by the number of types held instead of an array indexed
+    //by type id, for programs numbering many types of which each container only holds a few.
+    template<bool Local = false>
+    struct BasicHeterogeneousContainer_SparseSet3
+    {
+    private:
+        //Both modes number types alike
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, BasicHeterogeneousContainer_SparseSet3<>>(); }
+
+    public:
+        using index = std::uint16_t;
+        using offset_t = std::uint32_t;
+        using destructor_t = void(*)(void*);
+        using relocator_t = void(*)(void* from, void* to);
+        static constexpr index npos = index(-1);
+
+        struct metadata_t {
+            std::uint32_t size;
+            std::uint32_t alignment;
+            destructor_t destructor;//< nullptr when there is nothing to destroy
+            relocator_t relocate;//< nullptr when copying the bytes is enough
+        };
+
+        BasicHeterogeneousContainer_SparseSet3() = default;
+        //Tables and objects are allocated from resource
+        explicit BasicHeterogeneousContainer_SparseSet3(std::pmr::memory_resource* resource)
+            : sparse(resource), tags(resource), offsets(resource), metadata(resource), data(resource) {}
+        BasicHeterogeneousContainer_SparseSet3(const BasicHeterogeneousContainer_SparseSet3&) = delete;
+        BasicHeterogeneousContainer_SparseSet3& operator=(const BasicHeterogeneousContainer_SparseSet3&) = delete;
+        BasicHeterogeneousContainer_SparseSet3(BasicHeterogeneousContainer_SparseSet3&& other) noexcept
+            : sparse(std::move(other.sparse)), tags(std::move(other.tags)), offsets(std::move(other.offsets))
+            , metadata(std::move(other.metadata)), data(std::move(other.data)), present(other.present)
+        {
+            other.forget();
+        }
+        //Not noexcept: the tables of other are copied when its resource is not equal to the one of this
+        BasicHeterogeneousContainer_SparseSet3& operator=(BasicHeterogeneousContainer_SparseSet3&& other) {
+            if (this != &other) {
+                clear();
+                sparse = std::move(other.sparse);
+                tags = std::move(other.tags);
+                offsets = std::move(other.offsets);
+                metadata = std::move(other.metadata);
+                data = std::move(other.data);
+                present = other.present;
+                other.forget();
+            }
+            return *this;
+        }
+        ~BasicHeterogeneousContainer_SparseSet3() { clear(); }
+
+        std::conditional_t<Local, local_slots<index>, std::pmr::vector<index>> sparse;
+        //Dense side, offsets are kept apart from the rest as they are the only part read by get
+        std::pmr::vector<type_id_t> tags;
+        std::pmr::vector<offset_t> offsets;
+        std::pmr::vector<metadata_t> metadata;
+        mutable std::vector<std::byte, resource_allocator<std::byte, default_alignment>> data;
+        type_set present;//< tags of the dense side
+
+        std::pmr::memory_resource* resource() const noexcept { return data.get_allocator().resource; }
+
+        template<typename... Ts>
+        bool contains() const noexcept {
+            const type_mask& m = mask<Ts...>();
+            return m.exact ? present.includes(m.bits) : ((position(type_id<Ts>()) != npos) && ...);
+        }
+
+        //Types held by the container, to be tested against mask<Ts...>()
+        const type_set& presence() const noexcept { return present; }
+        template<typename... Ts>
+        static const type_mask& mask() {
+            static const type_mask m = type_mask::of(type_id<Ts>()...);
+            return m;
+        }
+
+        template<typename T>
+        T* has() const noexcept { return contains<T>() ? &get<T>() : nullptr; }
+
+        template<typename...Ts>
+        void reserve() { reserve(sizeof...(Ts), packing_table<Ts...>::layouts[0].size); }
+        void reserve(std::size_t n, std::size_t n_bytes = 0)
+        {
+            tags.reserve(n);
+            offsets.reserve(n);
+            metadata.reserve(n);
+            if (n_bytes > data.capacity())
+                reallocate(n_bytes - data.size());
+        }
+
+        template<typename T, typename... Rest>
+        decltype(auto) get() const noexcept
+        {
+            if constexpr (sizeof...(Rest) == 0) {
+                using U = std::remove_reference_t<T>;
+                assert(contains<U>());
+                return *std::launder(reinterpret_cast<U*>(data.data() + offsets[slot(type_id<U>())]));
+            }
+            else
+                return std::forward_as_tuple(get<T>(), get<Rest>()...);
+        }
+
+        template<typename T>
+        static constexpr bool must_be_copyable_if_lvalue = std::is_lvalue_reference_v<T> && std::is_copy_constructible_v<T>;
+        template<typename T>
+        static constexpr bool must_be_moveable_if_rvalue = (std::is_object_v<T> || std::is_rvalue_reference_v<T>) && std::is_move_constructible_v<T>;
+
+        template<typename T = void, typename... Args>
+        auto insert(Args&& ... args) -> decltype(auto)
+        {
+            if constexpr (std::is_same_v<T, void>)
+                static_assert(((must_be_copyable_if_lvalue<Args> || must_be_moveable_if_rvalue<Args>) && ...), "Use in-place version insert<T>(Args...) instead");
+
+            if constexpr (!std::is_same_v<T, void>)
+                return insert_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return insert_1<Args...>(std::forward<Args>(args)...);
+            else
+                return insert_n(std::index_sequence_for<Args...>{}, std::forward<Args>(args)...);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) insert_or_assign(Args&& ... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return insert_or_assign_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return insert_or_assign_1<Args...>(std::forward<Args>(args)...);
+            else
+                return std::forward_as_tuple(insert_or_assign_1<Args>(std::forward<Args>(args))...);
+        }
+
+        //Destroy the objects of types Ts..., the last dense entry takes the place of each one removed. Their bytes
+        //are only reclaimed when the buffer grows.
+        template<typename... Ts>
+        void erase() { (erase_1(type_id<Ts>()), ...); }
+
+        //Destroy every object, keeping the memory of the tables and of the buffer for the next insertions
+        void clear() noexcept
+        {
+            for (std::size_t i = 0; i < metadata.size(); ++i)
+                if (metadata[i].destructor)
+                    metadata[i].destructor(&data[offsets[i]]);
+            if constexpr (Local)
+                sparse.clear();
+            else
+                for (type_id_t tag : tags)
+                    sparse[tag] = npos;
+            tags.clear();
+            offsets.clear();
+            metadata.clear();
+            data.clear();
+            present.clear();
+        }
+
+    private:
+        index position(type_id_t id) const noexcept {
+            if constexpr (Local)
+                return sparse.find(id);
+            else
+                return id < sparse.size() ? sparse[id] : npos;
+        }
+        //Position of a type known to be held
+        index slot(type_id_t id) const noexcept {
+            if constexpr (Local)
+                return sparse.find(id);
+            else
+                return sparse[id];
+        }
+
+        template<typename T, typename... Args>
+        decltype(auto) insert_1(Args&& ... args)
+        {
+            using U = rm_cvref_t<T>;
+            static_assert(alignof(U) <= default_alignment);
+            assert(!contains<U>());
+            make_room(sizeof(U) + alignof(U) - 1);
+            const std::size_t offset = (data.size() + alignof(U) - 1) & ~(alignof(U) - 1);
+            data.resize(offset + sizeof(U));
+            return construct<U>(offset_t(offset), std::forward<Args>(args)...);
+        }
+
+        template<typename... Ts, std::size_t... I>
+        decltype(auto) insert_n(std::index_sequence<I...>, Ts&& ... values)
+        {
+            using table = packing_table<rm_cvref_t<Ts>...>;
+            static_assert(table::alignment <= default_alignment);
+            assert((!contains<Ts>() && ...));
+            constexpr std::size_t worst = [] {
+                std::size_t n = 0;
+                for (const auto& layout : table::layouts)
+                    n = std::max(n, layout.size);
+                return n;
+            }();
+            make_room(worst);
+            if (tags.size() + sizeof...(Ts) > tags.capacity())
+                reserve(tags.size() + sizeof...(Ts));
+            const std::size_t size_before = data.size();
+            const auto& layout = table::at(size_before);
+            data.resize(size_before + layout.size);
+            return std::tuple<rm_cvref_t<Ts>&...>{ construct<rm_cvref_t<Ts>>(offset_t(size_before + layout.offsets[I]), std::forward<Ts>(values))... };
+        }
+
+        template<typename T, typename... Args>
+        decltype(auto) insert_or_assign_1(Args&& ... args)
+        {
+            using U = rm_cvref_t<T>;
+            if (auto p = has<U>()) {
+                *p = U(std::forward<Args>(args)...);
+                return *p;
+            }
+            else
+                return insert_1<T>(std::forward<Args>(args)...);
+        }
+
+        template<typename U, typename... Args>
+        U& construct(offset_t offset, Args&& ... args)
+        {
+            U* instance = new(&data[offset]) U{ std::forward<Args>(args)... };
+            const type_id_t id = type_id<U>();
+            assert(tags.size() < npos && "Too many types for the index type");
+            if constexpr (Local)
+                sparse.insert(id, index(tags.size()));
+            else {
+                if (id >= sparse.size())
+                    sparse.resize(id + 1, npos);
+                sparse[id] = index(tags.size());
+            }
+            present.set(id);
+            tags.push_back(id);
+            offsets.push_back(offset);
+            metadata_t m{ sizeof(U), alignof(U), nullptr, nullptr };
+            if constexpr (!std::is_trivially_destructible_v<U>)
+                m.destructor = +[](void* p) { std::destroy_at(std::launder(static_cast<U*>(p))); };
+            if constexpr (!is_trivially_relocatable_v<U>)
+                m.relocate = +[](void* from, void* to) {
+                    U* p = std::launder(static_cast<U*>(from));
+                    new(to) U(std::move(*p));
+                    std::destroy_at(p);
+                };
+            metadata.push_back(m);
+            return *instance;
+        }
+
+        void erase_1(type_id_t id)
+        {
+            const index i = position(id);
+            assert(i != npos);
+            if (metadata[i].destructor)
+                metadata[i].destructor(&data[offsets[i]]);
+            if (std::size_t(i) + 1 != tags.size()) {
+                tags[i] = tags.back();
+                offsets[i] = offsets.back();
+                metadata[i] = metadata.back();
+                if constexpr (Local)
+                    sparse.assign(tags[i], i);
+                else
+                    sparse[tags[i]] = i;
+            }
+            if constexpr (Local)
+                sparse.erase(id);
+            else
+                sparse[id] = npos;
+            present.reset(id);
+            tags.pop_back();
+            offsets.pop_back();
+            metadata.pop_back();
+        }
+
+        //Make sure n more bytes fit at the end of the buffer without reallocating it
+        void make_room(std::size_t n)
+        {
+            if (data.size() + n > data.capacity())
+                reallocate(n);
+        }
+
+        //Move the live objects to a new buffer, packed with the padding-minimizing placement, leaving room for at
+        //least n more bytes. Bytes are copied in bulk unless the type is not trivially relocatable. The scratch tables
+        //come from the resource of the container.
+        void reallocate(std::size_t n)
+        {
+            const std::size_t count = metadata.size();
+            std::pmr::vector<std::size_t> alignments(count, resource()), sizes(count, resource()), to(count, resource());
+            std::pmr::vector<char> placed(count, false, resource());
+            for (std::size_t i = 0; i < count; ++i) {
+                alignments[i] = metadata[i].alignment;
+                sizes[i] = metadata[i].size;
+            }
+            const std::size_t size = pack_n(alignments, sizes, to, placed, count);
+
+            decltype(data) buffer(data.get_allocator());
+            buffer.reserve(std::max(2 * data.capacity(), size + n));
+            buffer.resize(size);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (metadata[i].relocate)
+                    metadata[i].relocate(&data[offsets[i]], &buffer[to[i]]);
+                else
+                    std::memcpy(&buffer[to[i]], &data[offsets[i]], metadata[i].size);
+                offsets[i] = offset_t(to[i]);
+            }
+            data = std::move(buffer);
+        }
+
+        //Leave this empty after its content was taken
+        void forget() noexcept
+        {
+            sparse.clear();
+            tags.clear();
+            offsets.clear();
+            metadata.clear();
+            data.clear();
+            present.clear();
+        }
+    };
+
+    using HeterogeneousContainer_SparseSet3 = BasicHeterogeneousContainer_SparseSet3<>;
+    using HeterogeneousContainer_SparseSet3_Local = BasicHeterogeneousContainer_SparseSet3<true>;
+}
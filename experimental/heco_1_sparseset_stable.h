@@ -26,15 +26,26 @@
 #include <algorithm>
 #include <numeric>
 #include <memory>
+#include <memory_resource>
 #include <unordered_map>
+#include <utility>
+#include "heco_packing.h"
+#include "heco_slab_pool.h"
+#include "heco_type_registry.h"
+#include "heco_type_set.h"
 
 namespace heco
 {
-    struct HeterogeneousContainer_SparseSet1;
+    template<typename Index = std::uint8_t>
+    struct BasicHeterogeneousContainer_SparseSet1;
     struct HeterogeneousContainer_SparseSet2;
+    using HeterogeneousContainer_SparseSet1 = BasicHeterogeneousContainer_SparseSet1<>;
     using HeterogeneousContainer_SparseSet = HeterogeneousContainer_SparseSet1;
 
-    struct HeterogeneousContainer_SparseSet1
+    //Sparse set of boxed objects. Index is the type of the positions stored in the sparse side and bounds the number
+    //of types a container can hold to Index(-1) - 1.
+    template<typename Index>
+    struct BasicHeterogeneousContainer_SparseSet1
     {
     private:
         template<typename K, typename V, typename... Args>
@@ -45,44 +56,106 @@ namespace heco
 
         using type_id_t = std::uint32_t;
 
-        class TypeCounter {
-            static inline type_id_t i = 0;
-        public:
-            template<typename T>
-            static inline const auto id = i++;
-        };
-        template<typename T> static inline auto type_id() { return TypeCounter::id<rm_cvref_t<T>>; }
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, BasicHeterogeneousContainer_SparseSet1>(); }
     
     public:
-        HeterogeneousContainer_SparseSet1() = default;
-        HeterogeneousContainer_SparseSet1(const HeterogeneousContainer_SparseSet1&) = delete;
-        HeterogeneousContainer_SparseSet1& operator=(const HeterogeneousContainer_SparseSet1&) = delete;
-        HeterogeneousContainer_SparseSet1(HeterogeneousContainer_SparseSet1&&) = default;
-        HeterogeneousContainer_SparseSet1& operator=(HeterogeneousContainer_SparseSet1&&) = default;
-        ~HeterogeneousContainer_SparseSet1() = default;
-
-        using ptr_dtor = std::unique_ptr<void, void(*)(void*)>;
+        BasicHeterogeneousContainer_SparseSet1() = default;
+        //Objects and tables are allocated from resource
+        explicit BasicHeterogeneousContainer_SparseSet1(std::pmr::memory_resource* resource) : sparse(resource), data(resource) {}
+        //Objects are allocated from the slab pool of their type, shared by all pooled containers, tables from resource
+        explicit BasicHeterogeneousContainer_SparseSet1(pooled_t, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : sparse(resource), data(resource), pooled(true) {}
+        BasicHeterogeneousContainer_SparseSet1(const BasicHeterogeneousContainer_SparseSet1&) = delete;
+        BasicHeterogeneousContainer_SparseSet1& operator=(const BasicHeterogeneousContainer_SparseSet1&) = delete;
+        BasicHeterogeneousContainer_SparseSet1(BasicHeterogeneousContainer_SparseSet1&& other) noexcept
+            : sparse(std::move(other.sparse)), data(std::move(other.data)), pooled(other.pooled), present(std::exchange(other.present, type_set{})) {}
+        BasicHeterogeneousContainer_SparseSet1& operator=(BasicHeterogeneousContainer_SparseSet1&& other) {
+            if (this != &other) {
+                release_pages();
+                if (*sparse.get_allocator().resource() == *other.sparse.get_allocator().resource())
+                    sparse = std::move(other.sparse);
+                else {
+                    //pages go back to the resource they came from, copy them into pages of ours
+                    sparse.assign(other.sparse.size(), nullptr);
+                    for (std::size_t page = 0; page < sparse.size(); ++page)
+                        if (other.sparse[page]) {
+                            sparse[page] = new_page();
+                            std::copy_n(other.sparse[page], page_size, sparse[page]);
+                        }
+                }
+                other.release_pages();
+                data = std::move(other.data);
+                other.data.clear();
+                pooled = other.pooled;
+                present = std::exchange(other.present, type_set{});
+            }
+            return *this;
+        }
+        ~BasicHeterogeneousContainer_SparseSet1() { release_pages(); }
+
+        using deleter = object_deleter;
+        using ptr_dtor = object_ptr;
         struct any { type_id_t tag; ptr_dtor ptr; };
-        using index = std::uint8_t;
-        std::vector<index> sparse;
-        std::vector<any> data;
+        using index = Index;
+        static constexpr index npos = index(-1);
+        static constexpr std::size_t page_size = 128;
+        //Position in data of each type, split in pages of page_size positions allocated from the resource on first use,
+        //so that a container only pays for the ranges of type ids it holds and a pointer for each other range
+        std::pmr::vector<index*> sparse;
+        std::pmr::vector<any> data;
+
+        bool pooled = false;
+        type_set present;//< tags of data
+
+        std::pmr::memory_resource* resource() const noexcept { return data.get_allocator().resource(); }
 
         template<typename... Ts>
-        bool contains() const noexcept { return ((sparse.size() > type_id<Ts>() && sparse[type_id<Ts>()] != index(-1)) && ...);}
+        bool contains() const noexcept {
+            const type_mask& m = mask<Ts...>();
+            return m.exact ? present.includes(m.bits) : ((position(type_id<Ts>()) != npos) && ...);
+        }
+
+        //Types held by the container, to be tested against mask<Ts...>()
+        const type_set& presence() const noexcept { return present; }
+        template<typename... Ts>
+        static const type_mask& mask() {
+            static const type_mask m = type_mask::of(type_id<Ts>()...);
+            return m;
+        }
 
         template<typename T>
         T* has() const noexcept { return contains<T>() ? &get<T>() : nullptr; }
 
         template<typename...Ts>
         void reserve() { reserve(sizeof...(Ts)); }
-        void reserve(std::size_t n) { sparse.reserve(n); data.reserve(n); }
+        void reserve(std::size_t n) { data.reserve(n); }
+
+        //Destroy the objects of types Ts..., the last object of data takes the place of each one removed
+        template<typename... Ts>
+        void erase() { (erase_1(type_id<Ts>()), ...); }
+
+        //Destroy every object, keeping the memory of the tables for the next insertions
+        void clear() noexcept
+        {
+            for (const any& entry : data)
+                sparse[entry.tag / page_size][entry.tag % page_size] = npos;
+            data.clear();
+            present.clear();
+        }
+
+        //Hint the cache to load the objects of Ts... ahead of get<Ts...>(), e.g. for the container processed a few
+        //iterations later. Finding their address reads the sparse and dense sides, the objects themselves are not read.
+        template<typename... Ts>
+        void prefetch() const noexcept { (prefetch_1(type_id<Ts>()), ...); }
 
         template<typename T, typename... Rest>
         auto get() noexcept -> decltype(auto)
         {
             using U = std::remove_reference_t<T>;
-            if constexpr (sizeof...(Rest) == 0)
-                return *static_cast<U*>(data[sparse[type_id<U>()]].ptr.get());
+            if constexpr (sizeof...(Rest) == 0) {
+                assert(contains<U>());
+                const type_id_t id = type_id<U>();
+                return *static_cast<U*>(data[sparse[id / page_size][id % page_size]].ptr.get());
+            }
             else
                 return std::forward_as_tuple(get<T>(), get<Rest>()...);
         }
@@ -91,8 +164,11 @@ namespace heco
         auto get() const noexcept -> decltype(auto)
         {
             using U = std::remove_reference_t<T>;
-            if constexpr (sizeof...(Rest) == 0)
-                return *static_cast<U*>(data[sparse[type_id<U>()]].ptr.get());
+            if constexpr (sizeof...(Rest) == 0) {
+                assert(contains<U>());
+                const type_id_t id = type_id<U>();
+                return *static_cast<U*>(data[sparse[id / page_size][id % page_size]].ptr.get());
+            }
             else
                 return std::forward_as_tuple(get<T>(), get<Rest>()...);
         }
@@ -119,20 +195,83 @@ namespace heco
         template<typename T, typename... Args>
         auto insert_1(Args&& ... args) -> decltype(auto)
         {
-            using U = rm_cvref_t<T>;
+            return put<T>(make_object<rm_cvref_t<T>>(pooled, resource(), std::forward<Args>(args)...));
+        }
+
+        //Hand the objects made by make_objects over to the container, in the order of Ts...
+        template<typename... Ts, std::size_t... I>
+        auto put_n(std::index_sequence<I...>, std::array<ptr_dtor, sizeof...(Ts)>&& objects) -> std::tuple<rm_cvref_t<Ts>&...>
+        {
+            return { put<Ts>(std::move(objects[I]))... };
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        U& put(ptr_dtor&& ptr)
+        {
             auto id = type_id<T>();
-            auto&& it = data.emplace_back(any{ id, std::unique_ptr<void, void(*)(void*)>{ new U{ std::forward<Args>(args)... }, +[](void* instance) { delete static_cast<U*>(instance); } } });
-            if (id >= sparse.size()) 
-                sparse.resize(id+1, -1);
-            sparse[id] = data.size()-1;
+            assert(data.size() < npos && "Too many types for the index type");
+            auto&& it = data.emplace_back(any{ id, std::move(ptr) });
+            position_or_page(id) = index(data.size() - 1);
+            present.set(id);
             return *static_cast<U*>(it.ptr.get());
         }
 
+        void prefetch_1(type_id_t id) const noexcept
+        {
+            const index i = position(id);
+            if (i != npos)
+                HECO_PREFETCH(data[i].ptr.get());
+        }
+
+        //Position of the type in data, npos when absent
+        index position(type_id_t id) const noexcept
+        {
+            const std::size_t page = id / page_size;
+            return (page < sparse.size() && sparse[page]) ? sparse[page][id % page_size] : npos;
+        }
+
+        void erase_1(type_id_t id)
+        {
+            const index i = position(id);
+            assert(i != npos);
+            if (std::size_t(i) + 1 != data.size()) {
+                data[i] = std::move(data.back());
+                sparse[data[i].tag / page_size][data[i].tag % page_size] = i;
+            }
+            sparse[id / page_size][id % page_size] = npos;
+            present.reset(id);
+            data.pop_back();
+        }
+
+        index& position_or_page(type_id_t id)
+        {
+            const std::size_t page = id / page_size;
+            if (page >= sparse.size())
+                sparse.resize(page + 1, nullptr);
+            if (!sparse[page]) {
+                sparse[page] = new_page();
+                std::fill_n(sparse[page], page_size, npos);
+            }
+            return sparse[page][id % page_size];
+        }
+
+        index* new_page() { return static_cast<index*>(sparse.get_allocator().resource()->allocate(page_size * sizeof(index), alignof(index))); }
+
+        void release_pages() noexcept
+        {
+            for (index* page : sparse)
+                if (page)
+                    sparse.get_allocator().resource()->deallocate(page, page_size * sizeof(index), alignof(index));
+            sparse.clear();
+        }
+
         template<typename... Ts>
         auto insert_n(Ts&& ... values) -> decltype(auto)
         {
             data.reserve(data.size() + sizeof...(Ts));
-            return std::forward_as_tuple(insert_1<Ts>(std::forward<Ts>(values))...);
+            if (pooled)
+                return std::forward_as_tuple(insert_1<Ts>(std::forward<Ts>(values))...);
+            return put_n<Ts...>(std::index_sequence_for<Ts...>{}, make_objects(resource(), std::forward<Ts>(values)...));
         }
 
         template<typename T = void, typename... Args>
@@ -171,30 +310,60 @@ namespace heco
 
         using type_id_t = std::uint32_t;
 
-        class TypeCounter {
-            static inline type_id_t i = 0;
-        public:
-            template<typename T>
-            static inline const auto id = i++;
-        };
-        template<typename T> static inline auto type_id() { return TypeCounter::id<rm_cvref_t<T>>; }
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, HeterogeneousContainer_SparseSet2>(); }
 
     public:
         HeterogeneousContainer_SparseSet2() = default;
+        //Objects and tables are allocated from resource
+        explicit HeterogeneousContainer_SparseSet2(std::pmr::memory_resource* resource) : sparse(resource), tags(resource), data(resource) {}
+        //Objects are allocated from the slab pool of their type, shared by all pooled containers, tables from resource
+        explicit HeterogeneousContainer_SparseSet2(pooled_t, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : sparse(resource), tags(resource), data(resource), pooled(true) {}
         HeterogeneousContainer_SparseSet2(const HeterogeneousContainer_SparseSet&) = delete;
         HeterogeneousContainer_SparseSet2& operator=(const HeterogeneousContainer_SparseSet2&) = delete;
-        HeterogeneousContainer_SparseSet2(HeterogeneousContainer_SparseSet2&&) = default;
-        HeterogeneousContainer_SparseSet2& operator=(HeterogeneousContainer_SparseSet2&&) = default;
+        HeterogeneousContainer_SparseSet2(HeterogeneousContainer_SparseSet2&& other) noexcept
+            : sparse(std::move(other.sparse)), tags(std::move(other.tags)), data(std::move(other.data))
+            , pooled(other.pooled), present(std::exchange(other.present, type_set{})) {}
+        HeterogeneousContainer_SparseSet2& operator=(HeterogeneousContainer_SparseSet2&& other) {
+            if (this != &other) {
+                sparse = std::move(other.sparse);
+                tags = std::move(other.tags);
+                data = std::move(other.data);
+                other.sparse.clear();
+                other.tags.clear();
+                other.data.clear();
+                pooled = other.pooled;
+                present = std::exchange(other.present, type_set{});
+            }
+            return *this;
+        }
         ~HeterogeneousContainer_SparseSet2() = default;
 
-        using ptr_dtor = std::unique_ptr<void, void(*)(void*)>;
-        std::vector<std::uint8_t> sparse;
-        std::vector<type_id_t> tags;
-        std::vector<ptr_dtor> data;
+        using deleter = object_deleter;
+        using ptr_dtor = object_ptr;
+        static constexpr std::uint8_t npos = std::uint8_t(-1);
+        std::pmr::vector<std::uint8_t> sparse;
+        std::pmr::vector<type_id_t> tags;
+        std::pmr::vector<ptr_dtor> data;
+
+        bool pooled = false;
+        type_set present;//< tags of data
 
+        std::pmr::memory_resource* resource() const noexcept { return data.get_allocator().resource(); }
+
+
+        template<typename... Ts>
+        bool contains() const noexcept {
+            const type_mask& m = mask<Ts...>();
+            return m.exact ? present.includes(m.bits) : ((sparse.size() > type_id<Ts>() && sparse[type_id<Ts>()] != npos) && ...);
+        }
 
+        //Types held by the container, to be tested against mask<Ts...>()
+        const type_set& presence() const noexcept { return present; }
         template<typename... Ts>
-        bool contains() const noexcept { return ((sparse.size() > type_id<Ts>() && sparse[type_id<Ts>()] != -1) && ...); }
+        static const type_mask& mask() {
+            static const type_mask m = type_mask::of(type_id<Ts>()...);
+            return m;
+        }
 
         template<typename T>
         T* has() const noexcept { return contains<T>() ? &get<T>() : nullptr; }
@@ -203,6 +372,35 @@ namespace heco
         void reserve() { reserve(sizeof...(Ts)); }
         void reserve(std::size_t n) { sparse.reserve(n); tags.reserve(n); data.reserve(n); }
 
+        //Destroy the objects of types Ts..., the last object of data takes the place of each one removed
+        template<typename... Ts>
+        void erase() { (erase_1(type_id<Ts>()), ...); }
+
+        //Destroy every object, keeping the memory of the tables for the next insertions
+        void clear() noexcept
+        {
+            for (type_id_t tag : tags)
+                sparse[tag] = npos;
+            tags.clear();
+            data.clear();
+            present.clear();
+        }
+
+        void erase_1(type_id_t id)
+        {
+            assert(id < sparse.size() && sparse[id] != npos);
+            const std::size_t i = sparse[id];
+            if (i + 1 != data.size()) {
+                data[i] = std::move(data.back());
+                tags[i] = tags.back();
+                sparse[tags[i]] = std::uint8_t(i);
+            }
+            sparse[id] = npos;
+            present.reset(id);
+            tags.pop_back();
+            data.pop_back();
+        }
+
         template<typename T, typename... Rest>
         auto get() noexcept -> decltype(auto)
         {
@@ -245,13 +443,26 @@ namespace heco
         template<typename T, typename... Args>
         auto insert_1(Args&& ... args) -> decltype(auto)
         {
-            using U = rm_cvref_t<T>;
+            return put<T>(make_object<rm_cvref_t<T>>(pooled, resource(), std::forward<Args>(args)...));
+        }
+
+        //Hand the objects made by make_objects over to the container, in the order of Ts...
+        template<typename... Ts, std::size_t... I>
+        auto put_n(std::index_sequence<I...>, std::array<ptr_dtor, sizeof...(Ts)>&& objects) -> std::tuple<rm_cvref_t<Ts>&...>
+        {
+            return { put<Ts>(std::move(objects[I]))... };
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        U& put(ptr_dtor&& ptr)
+        {
             auto id = type_id<T>();
-            auto&& it = data.emplace_back(ptr_dtor{ new U{ std::forward<Args>(args)... }, +[](void* instance) { delete static_cast<U*>(instance); } } );
+            auto&& it = data.emplace_back(std::move(ptr));
             tags.emplace_back(id);
             if (id >= sparse.size())
                 sparse.resize(id + 1, -1);
             sparse[id] = data.size() - 1;
+            present.set(id);
             return *static_cast<U*>(it.get());
         }
 
@@ -259,7 +470,9 @@ namespace heco
         auto insert_n(Ts&& ... values) -> decltype(auto)
         {
             data.reserve(data.size() + sizeof...(Ts));
-            return std::forward_as_tuple(insert_1<Ts>(std::forward<Ts>(values))...);
+            if (pooled)
+                return std::forward_as_tuple(insert_1<Ts>(std::forward<Ts>(values))...);
+            return put_n<Ts...>(std::index_sequence_for<Ts...>{}, make_objects(resource(), std::forward<Ts>(values)...));
         }
 
         template<typename T = void, typename... Args>
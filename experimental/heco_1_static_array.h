@@ -0,0 +1,292 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <bitset>
+#include <tuple>
+#include "heco_1_map_array.h"
+
+namespace heco {
+
+    //Heterogeneous array whose set of types is fixed at compile time. The byte layout is computed once per schema
+    //with the same padding-minimizing packing as HeterogeneousArray::do_allocate_n, objects live inside the
+    //container itself and every access resolves to a constant offset.
+    template<typename... Schema>
+    class HeterogeneousArray_Static
+    {
+        static_assert(sizeof...(Schema) > 0);
+        static_assert(all_types_different<Schema...>);
+        static_assert((std::is_same_v<Schema, rm_cvref_t<Schema>> && ...), "Schema types must not be cv or ref qualified");
+        static_assert(((alignof(Schema) <= default_alignment) && ...));
+
+        static constexpr std::size_t N = sizeof...(Schema);
+        template<typename T>
+        static constexpr std::size_t size_of = std::is_empty_v<T> ? 0 : sizeof(T);
+        template<typename T>
+        static constexpr std::size_t alignment_of = std::is_empty_v<T> ? 1 : alignof(T);
+
+    public:
+        using This = HeterogeneousArray_Static;
+        using offset_t = std::uint32_t;
+
+        static constexpr auto layout = pack<N>({ alignment_of<Schema>... }, { size_of<Schema>... });
+        static constexpr std::size_t alignment = std::max({ alignment_of<Schema>... });
+
+        template<typename T>
+        static constexpr bool in_schema = (std::is_same_v<rm_cvref_t<T>, Schema> || ...);
+
+        template<typename T>
+        static constexpr std::size_t index_of()
+        {
+            static_assert(in_schema<T>, "Type is not part of the schema");
+            constexpr bool matches[] = { std::is_same_v<rm_cvref_t<T>, Schema>... };
+            std::size_t i = 0;
+            while (!matches[i])
+                ++i;
+            return i;
+        }
+
+        HeterogeneousArray_Static() = default;
+        HeterogeneousArray_Static(const HeterogeneousArray_Static&) = delete;
+        HeterogeneousArray_Static& operator=(const HeterogeneousArray_Static&) = delete;
+        HeterogeneousArray_Static(HeterogeneousArray_Static&& other) { steal(other); }
+        HeterogeneousArray_Static& operator=(HeterogeneousArray_Static&& other) {
+            if (this != &other) {
+                clear();
+                steal(other);
+            }
+            return *this;
+        }
+        ~HeterogeneousArray_Static() { clear(); }
+
+    private:
+        alignas(alignment) mutable std::byte data[layout.size > 0 ? layout.size : 1];
+        std::bitset<N> constructed;
+
+    public:
+        template<typename T>
+        static constexpr bool is_allocated() { return in_schema<T>; }
+        bool is_allocated(const type_id_t& type) const { return ((type_id<Schema>() == type) || ...); }
+
+        template<typename T>
+        bool is_constructed() const {
+            if constexpr (in_schema<T>)
+                return constructed[index_of<T>()];
+            else
+                return false;
+        }
+        bool is_constructed(const type_id_t& type) const { return ((type_id<Schema>() == type && is_constructed<Schema>()) || ...); }
+
+        bool contains(const type_id_t& type) const { return is_constructed(type); }
+        template<typename... Ts>
+        bool contains() const { return (is_constructed<Ts>() && ...); }
+
+        //Types constructed in the container, numbered like in HeterogeneousArray
+        type_set presence() const noexcept {
+            type_set output;
+            ((is_constructed<Schema>() ? output.set(type_id<Schema>()) : void()), ...);
+            return output;
+        }
+        template<typename... Ts>
+        static const type_mask& mask() { return mask_of<Ts...>(); }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        auto has() const {
+            if constexpr (std::is_empty_v<U>)
+                return contains<U>();
+            else if constexpr (!in_schema<U>)
+                return (U*)nullptr;
+            else
+                return contains<U>() ? &do_get<U>() : (U*)nullptr;
+        }
+
+        template<typename T, typename... Rest>
+        static constexpr auto offset_of()
+        {
+            return array{ offset_t(layout.offsets[index_of<T>()]), offset_t(layout.offsets[index_of<Rest>()])... };
+        }
+
+        template<typename T, typename... Rest>
+        auto id_of() const
+        {
+            return array{ type_id<T>(), type_id<Rest>()... };
+        }
+
+        template<typename... Ts>
+        decltype(auto) get() const noexcept
+        {
+            static_assert(sizeof...(Ts) > 0);
+            if constexpr (sizeof...(Ts) == 1)
+                return (do_get<Ts>(), ...);
+            else
+                return std::forward_as_tuple(do_get<Ts>()...);
+        }
+
+        template<typename... Ts>
+        static constexpr auto reserve() { return offset_of<Ts...>(); }
+        void reserve(size_t, size_t = 0, size_t = 0) {}
+
+        template<typename T = void, typename... Args>
+        decltype(auto) construct(Args&& ... args)
+        {
+            if constexpr (std::is_same_v<T, void>)
+                static_assert(((must_be_copyable_if_lvalue<Args> || must_be_moveable_if_rvalue<Args>) && ...), "Use in-place version insert<T>(Args...) instead");
+
+            if constexpr (!std::is_same_v<T, void>)
+                return construct_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (construct_1<Args>(std::forward<Args>(args)), ...);
+            else
+                return construct_n(std::forward<Args>(args)...);
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) insert(Args&& ... args)
+        {
+            if constexpr (std::is_same_v<T, void>)
+                static_assert(((must_be_copyable_if_lvalue<Args> || must_be_moveable_if_rvalue<Args>) && ...), "Use in-place version insert<T>(Args...) instead");
+
+            if constexpr (!std::is_same_v<T, void>) {
+                assert(!contains<T>());
+                return construct_1<T>(std::forward<Args>(args)...);
+            }
+            else if constexpr (sizeof...(Args) == 1) {
+                assert(!contains<Args...>());
+                return (construct_1<Args>(std::forward<Args>(args)), ...);
+            }
+            else {
+                assert((!contains<Args>() && ...));
+                return construct_n(std::forward<Args>(args)...);
+            }
+        }
+
+        template<typename T = void, typename... Args>
+        decltype(auto) assign(Args&&... args)
+        {
+            if constexpr (!std::is_same_v<T, void>)
+                return assign_1<T>(std::forward<Args>(args)...);
+            else if constexpr (sizeof...(Args) == 1)
+                return (assign_1<Args>(std::forward<Args>(args)), ...);
+            else
+                return std::tuple<rm_cvref_t<Args>&...>{assign_1<Args>(std::forward<Args>(args))...};
+        }
+
+        //Storage of every type of the schema always exists, insert_or_assign is thus the same as assign
+        template<typename T = void, typename... Args>
+        decltype(auto) insert_or_assign(Args&& ... args)
+        {
+            return assign<T>(std::forward<Args>(args)...);
+        }
+
+        template<typename... Ts>
+        void destruct() {
+            (do_destruct<Ts>(), ...);
+        }
+
+        void clear()
+        {
+            (destroy_if_constructed<Schema>(), ...);
+        }
+
+    private:
+        template<typename T>
+        static constexpr bool must_be_copyable_if_lvalue = std::is_lvalue_reference_v<T> && std::is_copy_constructible_v<T>;
+        template<typename T>
+        static constexpr bool must_be_moveable_if_rvalue = (std::is_object_v<T> || std::is_rvalue_reference_v<T>) && std::is_move_constructible_v<T>;
+
+        template<typename T, typename... Args, typename U = rm_cvref_t<T>>
+        decltype(auto) construct_1(Args&& ... args)
+        {
+            assert(!is_constructed<U>());
+            constructed.set(index_of<U>());
+            if constexpr (std::is_empty_v<U>)
+                return;
+            else
+                return *new(&data[layout.offsets[index_of<U>()]]) U{ std::forward<Args>(args)... };
+        }
+
+        template<typename... Ts>
+        decltype(auto) construct_n(Ts&&... args)
+        {
+            constexpr bool all_empty = (std::is_empty_v<rm_cvref_t<Ts>> && ...);
+            constexpr bool none_empty = (!std::is_empty_v<rm_cvref_t<Ts>> && ...);
+            static_assert(all_empty || none_empty, "Cannot insert a mix of empty and non-empty types.");
+            if constexpr (all_empty)
+                (construct_1<Ts>(std::forward<Ts>(args)), ...);
+            else
+                return std::tuple<rm_cvref_t<Ts>&...>{construct_1<Ts>(std::forward<Ts>(args))...};
+        }
+
+        template<typename T, typename... Args, typename U = rm_cvref_t<T>>
+        decltype(auto) assign_1(Args&& ... args)
+        {
+            if (!is_constructed<U>())
+                return construct_1<U>(std::forward<Args>(args)...);
+            else if constexpr (std::is_empty_v<U>)
+                return;
+            else if constexpr (sizeof...(Args) == 1 && (std::is_same_v<U, rm_cvref_t<Args>> && ...))
+                return do_get<U>() = (std::forward<Args>(args), ...);
+            else
+                return do_get<U>() = U{ std::forward<Args>(args)... };
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        void do_destruct()
+        {
+            assert(contains<U>());
+            if constexpr (!std::is_empty_v<U> && !std::is_trivially_destructible_v<U>)
+                std::destroy_at(&do_get<U>());
+            constructed.reset(index_of<U>());
+        }
+
+        template<typename T>
+        void destroy_if_constructed()
+        {
+            if (is_constructed<T>())
+                do_destruct<T>();
+        }
+
+        template<typename T>
+        void move_from(This& other)
+        {
+            if (!other.is_constructed<T>())
+                return;
+            if constexpr (std::is_empty_v<T>)
+                construct_1<T>();
+            else
+                construct_1<T>(std::move(other.do_get<T>()));
+            other.do_destruct<T>();
+        }
+
+        void steal(This& other)
+        {
+            (move_from<Schema>(other), ...);
+        }
+
+        template<typename T, typename U = rm_cvref_t<T>>
+        T& do_get() const noexcept
+        {
+            static_assert(!std::is_empty_v<U>);
+            assert(is_constructed<U>());
+            return *std::launder(reinterpret_cast<U*>(&data[layout.offsets[index_of<U>()]]));
+        }
+    };
+}
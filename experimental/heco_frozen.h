@@ -0,0 +1,177 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "heco_type_registry.h"
+
+namespace heco
+{
+    //Read-only container made by freeze() out of the objects of another one, numbering its types in Family.
+    //The types held are indexed by a perfect hash: slot (id * multiplier) >> shift holds the id and the address of its
+    //object, so that get is one multiplication, one shift and one load. Nothing changes once built, any number of
+    //threads may read it at the same time without synchronizing.
+    template<typename Container, typename Family = Container>
+    class Frozen
+    {
+        template<typename T>
+        using rm_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;//remove_cvref_t from C++20 only
+
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, Family>(); }
+
+    public:
+        static constexpr type_id_t npos = type_id_t(-1);
+        //Multipliers tried for a table size before doubling it
+        static constexpr int attempts = 256;
+
+        struct alignas(16) slot {
+            type_id_t id = npos;
+            void* object = nullptr;//< nullptr for empty types
+        };
+
+        explicit Frozen(Container&& container)
+            : source(std::move(container)), table(source.resource())
+        {
+            build();
+        }
+        Frozen(const Frozen&) = delete;
+        Frozen& operator=(const Frozen&) = delete;
+        //Objects may move with the container, the table is filled again. Not noexcept, as the table is allocated anew
+        //from the resource of the container.
+        Frozen(Frozen&& other)
+            : source(std::move(other.source)), table(source.resource()), multiplier(other.multiplier), shift(other.shift)
+            , n_types(other.n_types)
+        {
+            table.resize(other.table.size());
+            fill();
+        }
+
+        //Give the objects back to a container which can be modified again
+        Container thaw() &&
+        {
+            table.clear();
+            return std::move(source);
+        }
+
+        std::size_t size() const noexcept { return n_types; }
+        //Number of slots of the table, at least size()
+        std::size_t capacity() const noexcept { return table.size(); }
+
+        template<typename... Ts>
+        bool contains() const noexcept { return ((at(type_id<Ts>()).id == type_id<Ts>()) && ...); }
+
+        template<typename T, typename U = std::remove_reference_t<T>>
+        auto has() const noexcept
+        {
+            const slot& s = at(type_id<U>());
+            if constexpr (std::is_empty_v<U>)
+                return s.id == type_id<U>();
+            else
+                return s.id == type_id<U>() ? static_cast<const U*>(s.object) : nullptr;
+        }
+
+        template<typename T, typename... Rest>
+        decltype(auto) get() const noexcept
+        {
+            if constexpr (sizeof...(Rest) == 0) {
+                using U = std::remove_reference_t<T>;
+                static_assert(!std::is_empty_v<U>);
+                const slot& s = at(type_id<U>());
+                assert(s.id == type_id<U>());
+                return *static_cast<const U*>(s.object);
+            }
+            else
+                return std::forward_as_tuple(get<T>(), get<Rest>()...);
+        }
+
+    private:
+        Container source;
+        std::pmr::vector<slot> table;
+        std::uint64_t multiplier = 1;
+        unsigned shift = 63;
+        std::size_t n_types = 0;
+
+        const slot& at(type_id_t id) const noexcept { return table[std::size_t((std::uint64_t(id) * multiplier) >> shift)]; }
+
+        //Smallest table with a multiplier sending every id to its own slot, tables grow when none of the attempts works
+        void build()
+        {
+            std::vector<type_id_t> ids;
+            source.visit_objects([&](type_id_t id, void*) { ids.push_back(id); });
+            n_types = ids.size();
+            unsigned bits = 1;
+            while ((std::size_t(1) << bits) < n_types)
+                ++bits;
+            std::uint64_t state = 0x9E3779B97F4A7C15ull;
+            std::vector<char> used;
+            for (;; ++bits) {
+                used.assign(std::size_t(1) << bits, false);
+                for (int attempt = 0; attempt < attempts; ++attempt) {
+                    const std::uint64_t candidate = next(state) | 1;
+                    std::fill(used.begin(), used.end(), false);
+                    bool perfect = true;
+                    for (type_id_t id : ids) {
+                        char& u = used[std::size_t((std::uint64_t(id) * candidate) >> (64 - bits))];
+                        if (u) {
+                            perfect = false;
+                            break;
+                        }
+                        u = true;
+                    }
+                    if (perfect) {
+                        multiplier = candidate;
+                        shift = 64 - bits;
+                        table.resize(used.size());
+                        fill();
+                        return;
+                    }
+                }
+            }
+        }
+
+        void fill()
+        {
+            std::fill(table.begin(), table.end(), slot{});
+            source.visit_objects([&](type_id_t id, void* object) {
+                slot& s = table[std::size_t((std::uint64_t(id) * multiplier) >> shift)];
+                assert(s.id == npos);
+                s = slot{ id, object };
+            });
+        }
+
+        //splitmix64, multipliers only depend on the ids so that freezing is reproducible
+        static std::uint64_t next(std::uint64_t& state) noexcept
+        {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+    };
+}
@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "heco_type_registry.h"
+
+namespace heco
+{
+    //Small open-addressing table from the type ids of a family to the slots of one container, 0, 1, 2... in the
+    //order the container hands them out. Its size follows the number of types held rather than the largest id, ids
+    //are spread with Fibonacci hashing and collisions resolved by linear probing. Keys are kept apart from slots so
+    //that probing only touches one array.
+    template<typename Slot = std::uint16_t>
+    class local_slots
+    {
+    public:
+        using slot_t = Slot;
+        static constexpr Slot npos = Slot(-1);
+
+        local_slots() = default;
+        explicit local_slots(std::pmr::memory_resource* resource) : keys(resource), slots(resource) {}
+        local_slots(local_slots&& other) noexcept
+            : keys(std::move(other.keys)), slots(std::move(other.slots)), count(std::exchange(other.count, 0)), shift(other.shift), mask(other.mask)
+        {
+            other.keys.clear();
+            other.slots.clear();
+        }
+        local_slots& operator=(local_slots&& other) noexcept {
+            if (this != &other) {
+                keys = std::move(other.keys);
+                slots = std::move(other.slots);
+                count = std::exchange(other.count, 0);
+                shift = other.shift;
+                mask = other.mask;
+                other.keys.clear();
+                other.slots.clear();
+            }
+            return *this;
+        }
+
+        std::size_t size() const noexcept { return count; }
+        std::size_t capacity() const noexcept { return keys.size(); }
+
+        //Slot of the type, npos when absent
+        Slot find(type_id_t id) const noexcept
+        {
+            if (count == 0)
+                return npos;
+            const type_id_t* k = keys.data();
+            for (std::size_t i = home(id);; i = (i + 1) & mask) {
+                const type_id_t key = k[i];
+                if (key == id)
+                    return slots[i];
+                if (key == empty)
+                    return npos;
+            }
+        }
+
+        //Give slot to a type not in the table yet
+        void insert(type_id_t id, Slot slot)
+        {
+            assert(id != empty && find(id) == npos);
+            if (2 * (count + 1) > keys.size())
+                rehash(keys.empty() ? min_capacity : 2 * keys.size());
+            place(id, slot);
+            ++count;
+        }
+
+        //Change the slot of a type in the table
+        void assign(type_id_t id, Slot slot) noexcept { slots[locate(id)] = slot; }
+
+        void erase(type_id_t id) noexcept
+        {
+            std::size_t hole = locate(id);
+            //Shift back the following entries of the cluster which are allowed to move up, so that no tombstone is needed
+            for (std::size_t i = (hole + 1) & mask; keys[i] != empty; i = (i + 1) & mask) {
+                const std::size_t h = home(keys[i]);
+                if (((i - h) & mask) >= ((i - hole) & mask)) {
+                    keys[hole] = keys[i];
+                    slots[hole] = slots[i];
+                    hole = i;
+                }
+            }
+            keys[hole] = empty;
+            --count;
+        }
+
+        //Forget every type, keeping the memory
+        void clear() noexcept
+        {
+            std::fill(keys.begin(), keys.end(), empty);
+            count = 0;
+        }
+
+    private:
+        static constexpr type_id_t empty = type_id_t(-1);
+        static constexpr std::size_t min_capacity = 8;
+
+        std::pmr::vector<type_id_t> keys;
+        std::pmr::vector<Slot> slots;
+        std::size_t count = 0;
+        unsigned shift = 32;//< 32 - log2(capacity)
+        std::size_t mask = 0;//< capacity - 1
+
+        std::size_t home(type_id_t id) const noexcept { return std::size_t(std::uint32_t(id * 2654435769u) >> shift); }
+
+        std::size_t locate(type_id_t id) const noexcept
+        {
+            assert(find(id) != npos);
+            std::size_t i = home(id);
+            while (keys[i] != id)
+                i = (i + 1) & mask;
+            return i;
+        }
+
+        void place(type_id_t id, Slot slot) noexcept
+        {
+            std::size_t i = home(id);
+            while (keys[i] != empty)
+                i = (i + 1) & mask;
+            keys[i] = id;
+            slots[i] = slot;
+        }
+
+        void rehash(std::size_t capacity)
+        {
+            std::pmr::vector<type_id_t> old_keys(capacity, empty, keys.get_allocator());
+            std::pmr::vector<Slot> old_slots(capacity, Slot{}, slots.get_allocator());
+            old_keys.swap(keys);
+            old_slots.swap(slots);
+            shift = 32;
+            while ((std::size_t(1) << (32 - shift)) < capacity)
+                --shift;
+            mask = capacity - 1;
+            for (std::size_t i = 0; i < old_keys.size(); ++i)
+                if (old_keys[i] != empty)
+                    place(old_keys[i], old_slots[i]);
+        }
+    };
+}
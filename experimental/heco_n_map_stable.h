@@ -22,11 +22,15 @@
 #include <cstddef>        // for size_t
 #include <cstdint>        // for std::uint32_t
 #include <memory>         // for unique_ptr
+#include <memory_resource> // for pmr::memory_resource, pmr::vector
 #include <tuple>          // for forward_as_tuple
 #include <type_traits>    // for remove_reference_t, remove_cv_t
 #include <unordered_map>  // for unordered_map
 #include <utility>        // for forward
 #include <vector>
+#include "heco_slab_pool.h"
+#include "heco_type_registry.h"
+#include "heco_type_set.h"
 
 namespace heco
 {
@@ -38,13 +42,7 @@ namespace heco
 
         using type_id_t = std::uint32_t;
 
-        class TypeCounter {
-            static inline type_id_t i = 0;
-        public:
-            template<typename T>
-            static inline const auto id = i++;
-        };
-        template<typename T> inline auto type_id() { return TypeCounter::id<rm_cvref_t<T>>; }
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, HeterogeneousContainer_n>(); }
 
         template<typename T>
         struct is_vector : public std::false_type {};
@@ -55,47 +53,89 @@ namespace heco
 
     public:
         HeterogeneousContainer_n() = default;
+        //Vectors, their elements and map nodes are allocated from resource
+        explicit HeterogeneousContainer_n(std::pmr::memory_resource* resource) : data(resource) {}
         HeterogeneousContainer_n(const HeterogeneousContainer_n&) = delete;
         HeterogeneousContainer_n& operator=(const HeterogeneousContainer_n&) = delete;
-        HeterogeneousContainer_n(HeterogeneousContainer_n&&) = default;
-        HeterogeneousContainer_n& operator=(HeterogeneousContainer_n&&) = default;
+        HeterogeneousContainer_n(HeterogeneousContainer_n&& other) noexcept
+            : data(std::move(other.data)), present(std::exchange(other.present, type_set{})) {}
+        HeterogeneousContainer_n& operator=(HeterogeneousContainer_n&& other) {
+            if (this != &other) {
+                data = std::move(other.data);
+                other.data.clear();
+                present = std::exchange(other.present, type_set{});
+            }
+            return *this;
+        }
         ~HeterogeneousContainer_n() = default;
 
-        using ptr_dtor = std::unique_ptr<void, void(*)(void*)>;
-        std::unordered_map<type_id_t, ptr_dtor> data;
+        using deleter = object_deleter;
+        using ptr_dtor = object_ptr;
+        std::pmr::unordered_map<type_id_t, ptr_dtor> data;
+        type_set present;//< keys of data
+
+        std::pmr::memory_resource* resource() const noexcept { return data.get_allocator().resource(); }
 
+        //Whether a vector was inserted for each of Ts...
+        template<typename... Ts>
+        bool contains() const noexcept {
+            const type_mask& m = mask<Ts...>();
+            return m.exact ? present.includes(m.bits) : (data.count(type_id<Ts>()) && ...);
+        }
+
+        //Types held by the container, to be tested against mask<Ts...>()
+        const type_set& presence() const noexcept { return present; }
+        template<typename... Ts>
+        static const type_mask& mask() {
+            static const type_mask m = type_mask::of(type_id<Ts>()...);
+            return m;
+        }
+
+        //Vector of the Ts held. It is a std::pmr::vector<T> allocating from resource(), the default resource for a
+        //default-constructed container: code binding the result to a std::vector<T>& must switch to std::pmr::vector<T>&,
+        //or to auto&, as it no longer compiles.
         template<typename T>
-        auto vector() noexcept -> std::vector<T>& {
-            return *static_cast<std::vector<T>*>(data.at(type_id<T>()).get());
+        auto vector() noexcept -> std::pmr::vector<T>& {
+            return *static_cast<std::pmr::vector<T>*>(data.at(type_id<T>()).get());
         }
 
         template<typename T>
         auto vector(std::size_t i) noexcept -> T& {
-            return (*static_cast<std::vector<T>*>(data.at(type_id<T>()).get()))[i];
+            return (*static_cast<std::pmr::vector<T>*>(data.at(type_id<T>()).get()))[i];
         }
 
         template<typename Arg, typename... Args, typename = std::enable_if_t<!is_vector_v<Arg>>>
         bool insert(Arg&& arg, Args&&... args) {
             static_assert((std::is_same_v<Arg, Args> && ...));
-            auto&& [it, b] = data.emplace(
-                type_id<Arg>()
-                , ptr_dtor(new std::vector{ std::forward<Arg>(arg),std::forward<Args>(args)... },
-                    [](void* instance) { delete static_cast<std::vector<Arg>*>(instance); }));
-            return b;
+            using U = rm_cvref_t<Arg>;
+            ptr_dtor ptr = make<U>();
+            auto&& v = *static_cast<std::pmr::vector<U>*>(ptr.get());
+            v.reserve(1 + sizeof...(Args));
+            v.push_back(std::forward<Arg>(arg));
+            (v.push_back(std::forward<Args>(args)), ...);
+            present.set(type_id<U>());
+            return data.emplace(type_id<U>(), std::move(ptr)).second;
         }
 
         template<typename Arg, typename... Args>
         bool insert(const std::vector<Arg>& arg, const std::vector<Args>&... args) {
             static_assert((std::is_same_v<Arg, Args> && ...));
-            std::vector<Arg> tmp(arg);
-            auto&& [it, b] = data.emplace(
-                type_id<Arg>()
-                , ptr_dtor(new std::vector(arg),
-                    [](void* instance) { delete static_cast<std::vector<Arg>*>(instance); }));
-            auto&& v = it->second;
+            ptr_dtor ptr = make<Arg>();
+            auto&& v = *static_cast<std::pmr::vector<Arg>*>(ptr.get());
+            v.assign(arg.begin(), arg.end());
             (v.insert(v.end(), args.begin(), args.end()), ...);
-            return b;
+            present.set(type_id<Arg>());
+            return data.emplace(type_id<Arg>(), std::move(ptr)).second;
         }
 
+    private:
+        //Empty vector of T allocated from, and allocating its elements from, the resource of the container
+        template<typename T>
+        ptr_dtor make()
+        {
+            std::pmr::memory_resource* r = resource();
+            using V = std::pmr::vector<T>;
+            return adopt_object(r, new(r->allocate(sizeof(V), alignof(V))) V(r));
+        }
     };
 }
\ No newline at end of file
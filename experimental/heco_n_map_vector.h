@@ -19,22 +19,23 @@
 // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
+#pragma once
+#include <cassert>
+#include <cmath>          // for floor
 #include <cstddef>        // for size_t
 #include <cstdint>        // for std::uint32_t
-#include <memory>         // for unique_ptr
+#include <memory>         // for uninitialized_move
+#include <new>            // for launder
 #include <tuple>          // for forward_as_tuple
 #include <type_traits>    // for remove_reference_t, remove_cv_t
 #include <unordered_map>  // for unordered_map
 #include <utility>        // for forward
 #include <vector>
 #include <memory_resource>
+#include "heco_type_registry.h"
 
 namespace heco
 {
-#include<memory>
-#include<cmath>
-#include<cassert>
-#include<iostream>
     using typeid_t = void(*)(void*);
 
     template<typename T>
@@ -50,7 +51,7 @@ namespace heco
         if (!std::is_trivially_destructible_v<T> && end == nullptr && start != nullptr)
             destroy_at<T>(start);
         if (!std::is_trivially_destructible_v<T> && end != nullptr && start != nullptr && end >= start)
-            for (auto it = start; it < end; it = static_cast<T*>(it) + sizeof(T))
+            for (T* it = static_cast<T*>(start); it < static_cast<T*>(end); ++it)
                 destroy_at<T>(it);
         return destroy_at<T>;
     }
@@ -64,30 +65,38 @@ namespace heco
         void* _sta = nullptr;
         void* _end = nullptr;
         void* _cap = nullptr;
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource();//< elements are allocated from it
+        std::size_t alignment = 1;//< of the elements, to give their memory back
 
         template<typename T>
-        static te_vector_base create() {
-            return te_vector<T>();
+        static te_vector_base create(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+            return te_vector<T>(resource);
         }
 
         te_vector_base()
         {}
-        te_vector_base(fp arg) :
-            dtor(arg)
+        te_vector_base(fp arg, std::pmr::memory_resource* resource, std::size_t align) :
+            dtor(arg), memory(resource), alignment(align)
         {}
         te_vector_base(const te_vector_base&) = delete;
         te_vector_base& operator=(const te_vector_base&) = delete;
-        te_vector_base(te_vector_base&& other)
+        //The elements and their resource are taken over
+        te_vector_base(te_vector_base&& other) noexcept
         {
             // dtor = std::exchange(other.dtor, nullptr);//why?
             dtor = other.dtor;
+            memory = other.memory;
+            alignment = other.alignment;
             _sta = std::exchange(other._sta, nullptr);
             _end = std::exchange(other._end, nullptr);
             _cap = std::exchange(other._cap, nullptr);
         }
-        te_vector_base& operator=(te_vector_base&& other) {
+        te_vector_base& operator=(te_vector_base&& other) noexcept {
             if (this != &other) {
+                release();
                 dtor = other.dtor;
+                memory = other.memory;
+                alignment = other.alignment;
                 _sta = std::exchange(other._sta, nullptr);
                 _end = std::exchange(other._end, nullptr);
                 _cap = std::exchange(other._cap, nullptr);
@@ -95,25 +104,32 @@ namespace heco
             return *this;
         };
 
-        ~te_vector_base() noexcept {
-            if (dtor != nullptr && _sta != nullptr)
-                dtor(_sta, _end);
-            if (_sta != nullptr)
-                free(_sta);
-        }
+        ~te_vector_base() noexcept { release(); }
+
+        std::pmr::memory_resource* resource() const noexcept { return memory; }
 
         typeid_t get_typeid() { return dtor(nullptr, nullptr); }
 
         template<typename T>
         auto& vector() {
-            assert(::get_typeid<T>() == get_typeid());
+            assert(heco::get_typeid<T>() == get_typeid());
             return *std::launder(reinterpret_cast<te_vector<T>*>(this));
         }
         template<typename T>
         auto& vector(size_t i) {
-            assert(::get_typeid<T>() == get_typeid());
+            assert(heco::get_typeid<T>() == get_typeid());
             return (*std::launder(reinterpret_cast<te_vector<T>*>(this)))[i];
         }
+
+    protected:
+        //Destroy the elements and give their memory back to the resource
+        void release() noexcept {
+            if (dtor != nullptr && _sta != nullptr)
+                dtor(_sta, _end);
+            if (_sta != nullptr)
+                memory->deallocate(_sta, static_cast<std::byte*>(_cap) - static_cast<std::byte*>(_sta), alignment);
+            _sta = _end = _cap = nullptr;
+        }
     };
 
     template<typename T>
@@ -126,23 +142,32 @@ namespace heco
         T* begin() { return static_cast<T*>(_sta); }
         T* end() { return static_cast<T*>(_end); }
 
-        te_vector() : te_vector_base(make_dtor<T>)
+        //Elements are allocated from resource
+        explicit te_vector(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : te_vector_base(make_dtor<T>, resource, alignof(T))
         {}
 
+        //Move the elements to a new allocation of n elements from the resource
         auto resize(size_t n) {
-            using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
-            T* new_start(reinterpret_cast<T*>(new Storage[n]));
-            _end = std::uninitialized_move(begin(), end(), new_start);
+            T* new_start = static_cast<T*>(memory->allocate(n * sizeof(T), alignof(T)));
+            T* new_end = std::uninitialized_move(begin(), end(), new_start);
+            release();
             _sta = new_start;
+            _end = new_end;
+            _cap = new_start + n;
         }
 
         static constexpr auto growth_factor = 1.5;
         T& push_back(T&& arg) {
-            if (size() >= capacity()) {
-                size_t n = std::floor((capacity() + 1) * growth_factor);
-                resize(n);
-                _cap = begin() + n;
-            }
+            if (size() >= capacity())
+                resize(size_t(std::floor((capacity() + 1) * growth_factor)));
+            T* obj = new(_end) T(std::move(arg));
+            _end = end() + 1;
+            return *obj;
+        }
+
+        T& push_back(const T& arg) {
+            if (size() >= capacity())
+                resize(size_t(std::floor((capacity() + 1) * growth_factor)));
             T* obj = new(_end) T(arg);
             _end = end() + 1;
             return *obj;
@@ -181,13 +206,7 @@ namespace heco
 
         using type_id_t = std::uint32_t;
 
-        class TypeCounter {
-            static inline type_id_t i = 0;
-        public:
-            template<typename T>
-            static inline const auto id = i++;
-        };
-        template<typename T> inline auto type_id() { return TypeCounter::id<rm_cvref_t<T>>; }
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, HeterogeneousContainer_n>(); }
 
         template<typename T>
         struct is_vector : public std::false_type {};
@@ -198,34 +217,46 @@ namespace heco
 
     public:
         HeterogeneousContainer_n() = default;
+        //Vectors, their elements and map nodes are allocated from resource
+        explicit HeterogeneousContainer_n(std::pmr::memory_resource* resource) : data(resource) {}
         HeterogeneousContainer_n(const HeterogeneousContainer_n&) = delete;
         HeterogeneousContainer_n& operator=(const HeterogeneousContainer_n&) = delete;
         HeterogeneousContainer_n(HeterogeneousContainer_n&&) = default;
         HeterogeneousContainer_n& operator=(HeterogeneousContainer_n&&) = default;
         ~HeterogeneousContainer_n() = default;
 
-        std::unordered_map<type_id_t, te_vector> data;
+        std::pmr::unordered_map<type_id_t, te_vector_base> data;
+
+        std::pmr::memory_resource* resource() const noexcept { return data.get_allocator().resource(); }
 
         template<typename T>
-        auto vector() noexcept -> std::vector<T>& {
-            return *std::launder(reinterpret_cast<std::vector<T>*>(data.at(type_id<T>())));
+        auto vector() -> te_vector<T>& {
+            return data.at(type_id<T>()).template vector<T>();
         }
 
         template<typename T>
-        auto vector(std::size_t i) noexcept -> T& {
-            return (*std::launder(reinterpret_cast<std::vector<T>*>(data.at(type_id<T>()))))[i];
+        auto vector(std::size_t i) -> T& {
+            return data.at(type_id<T>()).template vector<T>(i);
         }
 
-        template<typename Arg, typename... Args, typename = std::enable_if_t<!is_vector_v<Arg>>>
+        template<typename Arg, typename... Args, typename = std::enable_if_t<!is_vector_v<rm_cvref_t<Arg>>>>
         bool insert(Arg&& arg, Args&&... args) {
-            static_assert((std::is_same_v<Arg, Args> && ...));
-            return false;
+            static_assert((std::is_same_v<rm_cvref_t<Arg>, rm_cvref_t<Args>> && ...));
+            using U = rm_cvref_t<Arg>;
+            te_vector<U> v(resource());
+            v.push_back(std::forward<Arg>(arg));
+            (v.push_back(std::forward<Args>(args)), ...);
+            return data.emplace(type_id<U>(), std::move(v)).second;
         }
 
         template<typename Arg, typename... Args>
         bool insert(const std::vector<Arg>& arg, const std::vector<Args>&... args) {
             static_assert((std::is_same_v<Arg, Args> && ...));
-            return false;
+            te_vector<Arg> v(resource());
+            auto append = [&v](const auto& values) { for (const Arg& a : values) v.push_back(a); };
+            append(arg);
+            (append(args), ...);
+            return data.emplace(type_id<Arg>(), std::move(v)).second;
         }
 
     };
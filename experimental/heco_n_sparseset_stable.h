@@ -28,6 +28,7 @@
 #include <memory>
 #include <unordered_map>
 #include "vectr.h"
+#include "heco_type_registry.h"
 
 namespace heco
 {
@@ -51,13 +52,7 @@ namespace heco
 
         using type_id_t = std::uint32_t;
 
-        class TypeCounter {
-            static inline type_id_t i = 0;
-        public:
-            template<typename T>
-            static inline const auto id = i++;
-        };
-        template<typename T> static inline auto type_id() { return TypeCounter::id<rm_cvref_t<T>>; }
+        template<typename T> static inline auto type_id() { return dense_type_id<rm_cvref_t<T>, HeterogeneousContainer_SparseSet>(); }
 
     public:
         HeterogeneousContainer_SparseSet1() = default;
@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <memory_resource>
+#include <new>
+
+//Hint the cache to load the line holding address, which may be anything including nullptr as it is not dereferenced
+#ifndef HECO_PREFETCH
+#if defined(__GNUC__) || defined(__clang__)
+#define HECO_PREFETCH(address) __builtin_prefetch(static_cast<const void*>(address))
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define HECO_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define HECO_PREFETCH(address) ((void)(address))
+#endif
+#endif
+
+namespace heco
+{
+    template<std::size_t N>
+    struct packing {
+        std::array<std::size_t, N> offsets = {};
+        std::size_t size = 0;
+    };
+
+    //Place N objects one after the other starting from address ptr_end, picking at each step the object requiring the
+    //smallest padding, and among those the largest one. Offsets are relative to ptr_end, the total size is returned.
+    //placed is scratch space of N elements initialized to false.
+    template<typename Sizes, typename Offsets, typename Flags>
+    constexpr std::size_t pack_n(const Sizes& alignments, const Sizes& sizes, Offsets& offsets, Flags& placed, std::size_t N, std::uintptr_t ptr_end = 0)
+    {
+        std::size_t size = 0;
+        for (std::size_t n = 0; n < N; ++n)
+        {
+            std::size_t id_element = N;
+            std::size_t min_padding = 0;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (placed[i])
+                    continue;
+                const std::size_t padding = ((~ptr_end + 1) & (alignments[i] - 1));
+                if (id_element == N || padding < min_padding || (padding == min_padding && sizes[i] > sizes[id_element])) {
+                    id_element = i;
+                    min_padding = padding;
+                }
+            }
+            offsets[id_element] = size + min_padding;
+            size += min_padding + sizes[id_element];
+            ptr_end += min_padding + sizes[id_element];
+            placed[id_element] = true;
+        }
+        return size;
+    }
+
+    template<std::size_t N>
+    constexpr packing<N> pack(const std::array<std::size_t, N>& alignments, const std::array<std::size_t, N>& sizes, std::uintptr_t ptr_end = 0)
+    {
+        packing<N> output;
+        std::array<bool, N> placed = {};
+        output.size = pack_n(alignments, sizes, output.offsets, placed, N, ptr_end);
+        return output;
+    }
+
+    //Result of pack() for Ts... and every possible misalignment of the end of the buffer. Only the end address modulo
+    //the largest alignment matters, so allocating at runtime is a lookup in this table.
+    template<typename... Ts>
+    struct packing_table
+    {
+        static constexpr std::size_t N = sizeof...(Ts);
+        static constexpr std::size_t alignment = std::max({ alignof(Ts)... });
+
+        static constexpr std::array<packing<N>, alignment> make()
+        {
+            std::array<packing<N>, alignment> output = {};
+            for (std::size_t misalignment = 0; misalignment < alignment; ++misalignment)
+                output[misalignment] = pack<N>({ alignof(Ts)... }, { sizeof(Ts)... }, misalignment);
+            return output;
+        }
+        static constexpr std::array<packing<N>, alignment> layouts = make();
+
+        static constexpr const packing<N>& at(std::uintptr_t ptr_end) { return layouts[ptr_end & (alignment - 1)]; }
+    };
+
+    //Header of a single allocation holding several objects packed together, see packed_block. The allocation goes
+    //back to its resource along with the last of its objects.
+    struct block_header
+    {
+        std::size_t count;//< objects not destroyed yet
+        std::size_t size;
+        std::size_t alignment;
+        std::pmr::memory_resource* resource;
+
+        static void release(block_header* block) noexcept
+        {
+            if (--block->count == 0)
+                block->resource->deallocate(block, block->size, block->alignment);
+        }
+    };
+
+    //Allocation holding a block_header followed by one object of each of Ts... placed with pack()
+    template<typename... Ts>
+    struct packed_block
+    {
+        static constexpr std::size_t N = sizeof...(Ts);
+        static constexpr const packing<N>& layout = packing_table<Ts...>::at(sizeof(block_header));
+        static constexpr std::size_t alignment = std::max(packing_table<Ts...>::alignment, alignof(block_header));
+        static constexpr std::size_t size = sizeof(block_header) + layout.size;
+
+        static block_header* allocate(std::pmr::memory_resource* resource)
+        {
+            return new(resource->allocate(size, alignment)) block_header{ N, size, alignment, resource };
+        }
+
+        template<std::size_t I>
+        static void* at(block_header* block) noexcept
+        {
+            return reinterpret_cast<std::byte*>(block) + sizeof(block_header) + layout.offsets[I];
+        }
+    };
+}
@@ -0,0 +1,162 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace heco
+{
+    //Tag selecting the deferred mode of the containers, whose destructor hands the objects over to a reclaim_queue
+    struct deferred_t { explicit deferred_t() = default; };
+    inline constexpr deferred_t deferred{};
+
+    //Queue of retired containers destroyed later, in bounded batches by drain() at points of the program where it does
+    //not hurt, or by a thread of its own once started. Retiring costs one allocation and a short lock, whatever the
+    //objects held, so that a thread serving requests does not pay for tearing down heavy objects.
+    //The memory resources of the containers retired must outlive their draining, and be thread-safe when the queue runs
+    //a thread of its own, as memory is given back to them from the thread draining, e.g. not a
+    //std::pmr::unsynchronized_pool_resource.
+    class reclaim_queue
+    {
+        struct retired {
+            retired* next;
+            void(*destroy)(retired* self);
+        };
+        template<typename T>
+        struct holder : retired {
+            T value;
+        };
+    public:
+        //Containers destroyed at once by the background thread before it checks the queue again
+        static constexpr std::size_t batch = 64;
+        //Longest the background thread sleeps before looking at the queue again
+        static constexpr std::chrono::milliseconds period{ 100 };
+
+        reclaim_queue() = default;
+        reclaim_queue(const reclaim_queue&) = delete;
+        reclaim_queue& operator=(const reclaim_queue&) = delete;
+        //Everything still queued is destroyed
+        ~reclaim_queue()
+        {
+            stop();
+            drain();
+        }
+
+        //Take garbage over, it is destroyed when drained, first retired first destroyed
+        template<typename T>
+        void retire(T&& garbage)
+        {
+            using U = std::remove_cv_t<std::remove_reference_t<T>>;
+            retired* r = new holder<U>{ { nullptr, +[](retired* self) { delete static_cast<holder<U>*>(self); } }, std::forward<T>(garbage) };
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                (tail ? tail->next : head) = r;
+                tail = r;
+                ++count;
+            }
+            wake.notify_one();
+        }
+
+        //Destroy up to max retired containers and return how many were, the lock is not held while destroying
+        std::size_t drain(std::size_t max = std::size_t(-1))
+        {
+            retired* first = nullptr;
+            std::size_t n = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                first = head;
+                retired* last = nullptr;
+                for (retired* r = head; r && n < max; r = r->next, ++n)
+                    last = r;
+                if (last) {
+                    head = last->next;
+                    last->next = nullptr;
+                    if (!head)
+                        tail = nullptr;
+                }
+                count -= n;
+            }
+            for (retired* r = first; n > 0 && r;) {
+                retired* next = r->next;
+                r->destroy(r);
+                r = next;
+            }
+            return n;
+        }
+
+        //Number of containers waiting for destruction
+        std::size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return count;
+        }
+
+        //Drain the queue on a thread of its own until stop()
+        void start()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (worker.joinable())
+                return;
+            stopping = false;
+            worker = std::thread([this] {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait_for(lock, period, [this] { return head || stopping; });
+                    if (stopping)
+                        return;
+                    if (!head)
+                        continue;
+                    lock.unlock();
+                    drain(batch);
+                    lock.lock();
+                }
+            });
+        }
+
+        //Stop the background thread, what it did not drain stays queued
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!worker.joinable())
+                    return;
+                stopping = true;
+            }
+            wake.notify_all();
+            worker.join();
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        retired* head = nullptr;
+        retired* tail = nullptr;
+        std::size_t count = 0;
+        bool stopping = false;
+        std::thread worker;
+    };
+}
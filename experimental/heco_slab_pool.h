@@ -0,0 +1,166 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+#include "heco_packing.h"
+
+namespace heco
+{
+    //Tag selecting the pooled mode of the stable containers
+    struct pooled_t { explicit pooled_t() = default; };
+    inline constexpr pooled_t pooled{};
+
+    //Pool of fixed-size slots carved out of large slabs. A slot never moves while in use and freed slots are threaded
+    //in a free list to be handed out again, so that steady-state allocation does not touch the global allocator.
+    //A pool is shared by every type of the same size and alignment across all containers, hence the lock.
+    template<std::size_t Size, std::size_t Alignment>
+    class slab_pool
+    {
+        struct node { node* next; };
+    public:
+        static constexpr std::size_t slot_alignment = std::max(Alignment, alignof(node));
+        static constexpr std::size_t slot_size = (std::max(Size, sizeof(node)) + slot_alignment - 1) / slot_alignment * slot_alignment;
+        static constexpr std::size_t slab_size = std::max<std::size_t>(16 * slot_size, 16 * 1024);
+        static constexpr std::size_t slots_per_slab = slab_size / slot_size;
+
+        //Slabs are never released: objects owned by static containers may outlive any static pool
+        static slab_pool& instance()
+        {
+            static slab_pool* pool = new slab_pool;
+            return *pool;
+        }
+
+        void* allocate()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (free_list) {
+                node* slot = free_list;
+                free_list = slot->next;
+                --n_free;
+                return slot;
+            }
+            if (cursor == end)
+                add_slab();
+            void* slot = cursor;
+            cursor += slot_size;
+            return slot;
+        }
+
+        void deallocate(void* slot) noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            free_list = new(slot) node{ free_list };
+            ++n_free;
+        }
+
+        //Number of slots in all slabs, and number of those not in use
+        std::size_t capacity() const { std::lock_guard<std::mutex> lock(mutex); return n_slabs * slots_per_slab; }
+        std::size_t available() const { std::lock_guard<std::mutex> lock(mutex); return n_free + std::size_t(end - cursor) / slot_size; }
+
+    private:
+        slab_pool() = default;
+
+        mutable std::mutex mutex;
+        node* free_list = nullptr;
+        std::byte* cursor = nullptr;//< first slot never handed out in the last slab
+        std::byte* end = nullptr;
+        std::size_t n_free = 0;
+        std::size_t n_slabs = 0;
+
+        void add_slab()
+        {
+            cursor = static_cast<std::byte*>(::operator new(slab_size, std::align_val_t(slot_alignment)));
+            end = cursor + slots_per_slab * slot_size;
+            ++n_slabs;
+        }
+    };
+
+    template<typename T>
+    using slab_pool_of = slab_pool<sizeof(T), alignof(T)>;
+
+    //Destroys an object and gives its memory back to where it came from, a resource, a pool or a shared block
+    struct object_deleter {
+        void(*destroy)(void* instance, void* context);
+        void* context;
+        void operator()(void* instance) const { destroy(instance, context); }
+    };
+    //Type-erased owner of an object of the stable containers
+    using object_ptr = std::unique_ptr<void, object_deleter>;
+
+    //Take ownership of instance, constructed in memory allocated from resource
+    template<typename U>
+    object_ptr adopt_object(std::pmr::memory_resource* resource, U* instance)
+    {
+        return object_ptr{ instance, object_deleter{ +[](void* instance, void* resource) {
+            std::destroy_at(static_cast<U*>(instance));
+            static_cast<std::pmr::memory_resource*>(resource)->deallocate(instance, sizeof(U), alignof(U));
+        }, resource } };
+    }
+
+    //Construct a U in a slot of its slab pool when pooled, in memory allocated from resource otherwise
+    template<typename U, typename... Args>
+    object_ptr make_object(bool pooled, std::pmr::memory_resource* resource, Args&&... args)
+    {
+        if (pooled) {
+            U* instance = new(slab_pool_of<U>::instance().allocate()) U{ std::forward<Args>(args)... };
+            return object_ptr{ instance, object_deleter{ +[](void* instance, void*) {
+                std::destroy_at(static_cast<U*>(instance));
+                slab_pool_of<U>::instance().deallocate(instance);
+            }, nullptr } };
+        }
+        return adopt_object(resource, new(resource->allocate(sizeof(U), alignof(U))) U{ std::forward<Args>(args)... });
+    }
+
+    //Construct a U at where, inside block, which is freed along with the last of its objects
+    template<typename U, typename... Args>
+    object_ptr make_object_at(block_header* block, void* where, Args&&... args)
+    {
+        U* instance = new(where) U{ std::forward<Args>(args)... };
+        return object_ptr{ instance, object_deleter{ +[](void* instance, void* block) {
+            std::destroy_at(static_cast<U*>(instance));
+            block_header::release(static_cast<block_header*>(block));
+        }, block } };
+    }
+
+    template<typename... Ts, std::size_t... I>
+    std::array<object_ptr, sizeof...(Ts)> make_objects(std::index_sequence<I...>, std::pmr::memory_resource* resource, Ts&&... values)
+    {
+        using block = packed_block<std::remove_cv_t<std::remove_reference_t<Ts>>...>;
+        block_header* header = block::allocate(resource);
+        return { make_object_at<std::remove_cv_t<std::remove_reference_t<Ts>>>(header, block::template at<I>(header), std::forward<Ts>(values))... };
+    }
+
+    //Construct one object of each of Ts... in a single allocation from resource laid out by packed_block, the objects
+    //keep their own lifetime and the allocation is freed once every one of them is destroyed
+    template<typename... Ts>
+    std::array<object_ptr, sizeof...(Ts)> make_objects(std::pmr::memory_resource* resource, Ts&&... values)
+    {
+        return make_objects(std::index_sequence_for<Ts...>{}, resource, std::forward<Ts>(values)...);
+    }
+}
@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//The registry must be a single object in the whole process. Inline functions are merged across shared objects on
+//ELF platforms as long as their symbol is visible, define HECO_TYPE_REGISTRY_API to __declspec(dllexport/dllimport)
+//where that is not the case.
+#ifndef HECO_TYPE_REGISTRY_API
+#if defined(__GNUC__) || defined(__clang__)
+#define HECO_TYPE_REGISTRY_API __attribute__((visibility("default")))
+#else
+#define HECO_TYPE_REGISTRY_API
+#endif
+#endif
+
+namespace heco
+{
+    using type_id_t = std::uint32_t;
+    using type_hash_t = std::uint64_t;
+
+    //Name of T as spelled by the compiler, available at compile time
+    template<typename T>
+    constexpr std::string_view type_name() noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        constexpr std::string_view signature = __FUNCSIG__;
+        constexpr std::size_t begin = signature.find("type_name<") + 10;
+        constexpr std::size_t end = signature.rfind(">(void)");
+#else
+        constexpr std::string_view signature = __PRETTY_FUNCTION__;
+        constexpr std::size_t begin = signature.find("T = ") + 4;
+        constexpr std::size_t end = signature.find(';', begin) != std::string_view::npos ? signature.find(';', begin) : signature.rfind(']');
+#endif
+        return signature.substr(begin, end - begin);
+    }
+
+    //FNV-1a
+    constexpr type_hash_t hash(std::string_view text) noexcept
+    {
+        type_hash_t output = 14695981039346656037ull;
+        for (char c : text)
+            output = (output ^ type_hash_t(static_cast<unsigned char>(c))) * 1099511628211ull;
+        return output;
+    }
+
+    //Identifier of T computed at compile time from its name, identical in every shared object and every run built by
+    //the same compiler. Types without a name of their own, such as two lambdas of the same scope, cannot be told apart.
+    template<typename T>
+    inline constexpr type_hash_t stable_type_id = hash(type_name<T>());
+
+    //Hands out dense ids, 0, 1, 2..., per family of containers. A type is known by its stable id, so that it gets the
+    //same dense id whichever shared object asks first. Registration takes a lock, it only happens once per type and
+    //family, on first use.
+    class HECO_TYPE_REGISTRY_API type_registry
+    {
+    public:
+        //Never destroyed, ids are used by objects living in static storage
+        static type_registry& instance()
+        {
+            static type_registry* registry = new type_registry;
+            return *registry;
+        }
+
+        type_id_t id(type_hash_t family, type_hash_t type, std::string_view name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            family_t& f = families[family];
+            auto&& [it, inserted] = f.ids.try_emplace(type, type_id_t(f.names.size()));
+            if (inserted)
+                f.names.emplace_back(name);
+            else if (f.names[it->second] != name)
+                throw std::logic_error("heco::type_registry: " + std::string(name) + " and " + f.names[it->second] + " share the same stable id");
+            return it->second;
+        }
+
+        //Number of ids handed out in a family
+        std::size_t size(type_hash_t family) const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto it = families.find(family);
+            return it != families.end() ? it->second.names.size() : 0;
+        }
+
+        std::string name(type_hash_t family, type_id_t id) const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return families.at(family).names.at(id);
+        }
+
+    private:
+        type_registry() = default;
+
+        struct family_t {
+            std::unordered_map<type_hash_t, type_id_t> ids;
+            std::vector<std::string> names;//< by dense id
+        };
+        mutable std::mutex mutex;
+        std::unordered_map<type_hash_t, family_t> families;
+    };
+
+    //Dense id of T in Family, unregistered until looked up. Constant-initialized, so that it reads unregistered rather
+    //than garbage before any dynamic initialization has run, whichever translation unit asks.
+    inline constexpr type_id_t unregistered = type_id_t(-1);
+    template<typename T, typename Family>
+    inline std::atomic<type_id_t> dense_type_id_cache{ unregistered };
+
+    //Kept out of line, so that the lookup of an id already known stays a load and a branch
+    template<typename T, typename Family>
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((noinline, cold))
+#endif
+    type_id_t register_dense_type_id()
+    {
+        const type_id_t id = type_registry::instance().id(stable_type_id<Family>, stable_type_id<T>, type_name<T>());
+        dense_type_id_cache<T, Family>.store(id, std::memory_order_relaxed);
+        return id;
+    }
+
+    //Dense id of T among the types of Family, looked up on first use, which is valid even from the static initializer
+    //of another translation unit. Threads racing on the first use get the same id from the registry.
+    //Family void holds the ids shared by the HeterogeneousArray variants.
+    template<typename T, typename Family = void>
+    inline type_id_t dense_type_id()
+    {
+        const type_id_t id = dense_type_id_cache<T, Family>.load(std::memory_order_relaxed);
+        return id != unregistered ? id : register_dense_type_id<T, Family>();
+    }
+}
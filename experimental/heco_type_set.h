@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright(c) 2020 Fabien Pan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HECO_SSE2
+#endif
+
+namespace heco
+{
+    //Fixed-size bitset over dense type ids, one bit per type. Words are laid out to be loaded as whole SIMD registers,
+    //so that testing a set of types against it is a handful of AND, whatever the number of types tested.
+    template<std::size_t Bits = 256>
+    struct alignas(32) basic_type_set
+    {
+        static_assert(Bits % 128 == 0, "Whole SSE registers are loaded");
+        static constexpr std::size_t capacity = Bits;
+        static constexpr std::size_t n_words = Bits / 64;
+
+        std::uint64_t words[n_words] = {};
+
+        //Ids at or beyond capacity have no bit, containers keep answering those with their own lookup
+        static constexpr bool representable(std::size_t id) noexcept { return id < capacity; }
+
+        void set(std::size_t id) noexcept { if (representable(id)) words[id / 64] |= std::uint64_t(1) << (id % 64); }
+        void reset(std::size_t id) noexcept { if (representable(id)) words[id / 64] &= ~(std::uint64_t(1) << (id % 64)); }
+        bool test(std::size_t id) const noexcept { return (words[id / 64] >> (id % 64)) & 1; }
+        void clear() noexcept { *this = basic_type_set{}; }
+
+        //Whether every bit of mask is also set here
+        bool includes(const basic_type_set& mask) const noexcept
+        {
+#ifdef HECO_SSE2
+            __m128i missing = _mm_setzero_si128();
+            for (std::size_t i = 0; i < n_words; i += 2) {
+                const __m128i have = _mm_load_si128(reinterpret_cast<const __m128i*>(words + i));
+                const __m128i want = _mm_load_si128(reinterpret_cast<const __m128i*>(mask.words + i));
+                missing = _mm_or_si128(missing, _mm_andnot_si128(have, want));
+            }
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+#else
+            std::uint64_t missing = 0;
+            for (std::size_t i = 0; i < n_words; ++i)
+                missing |= mask.words[i] & ~words[i];
+            return missing == 0;
+#endif
+        }
+
+        bool operator==(const basic_type_set& other) const noexcept
+        {
+            for (std::size_t i = 0; i < n_words; ++i)
+                if (words[i] != other.words[i])
+                    return false;
+            return true;
+        }
+        bool operator!=(const basic_type_set& other) const noexcept { return !(*this == other); }
+
+        basic_type_set operator|(const basic_type_set& other) const noexcept
+        {
+            basic_type_set output;
+            for (std::size_t i = 0; i < n_words; ++i)
+                output.words[i] = words[i] | other.words[i];
+            return output;
+        }
+    };
+
+    using type_set = basic_type_set<>;
+
+    //Bits of a list of types, computed once per list. exact is false when one of the ids has no bit, the mask alone
+    //then cannot answer and the container falls back to looking each type up.
+    struct type_mask
+    {
+        type_set bits;
+        bool exact = true;
+
+        void add(std::size_t id) noexcept
+        {
+            exact = exact && type_set::representable(id);
+            bits.set(id);
+        }
+
+        template<typename... Ids>
+        static type_mask of(Ids... ids) noexcept
+        {
+            type_mask output;
+            (output.add(ids), ...);
+            return output;
+        }
+    };
+
+    //Copy to out a pointer to every container of [first, last) holding all of Ts..., in order. The type sets of the
+    //containers are scanned one after the other, each test being a few SIMD AND against a mask computed once.
+    template<typename... Ts, typename It, typename Out>
+    Out filter(It first, It last, Out out)
+    {
+        using Container = std::remove_reference_t<decltype(*first)>;
+        const type_mask& mask = Container::template mask<Ts...>();
+        for (; first != last; ++first) {
+            auto& container = *first;
+            if (mask.exact ? container.presence().includes(mask.bits) : container.template contains<Ts...>())
+                *out++ = &container;
+        }
+        return out;
+    }
+}
@@ -0,0 +1,150 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_1_hybrid_array.h>
+#undef protected
+#undef private
+
+using namespace heco;
+
+struct A
+{
+    int x = 0;
+    char c = 0;
+    ~A() {};
+};
+static_assert(std::is_trivially_destructible_v < A > == false);
+static_assert(alignof(A) == 4);
+static_assert(sizeof(A) == 8);
+
+struct B
+{
+    double x = 0;
+    int y[4] = {};
+    A z{};
+};
+static_assert(std::is_trivially_destructible_v < B > == false);
+
+struct alignas(8) C { int v; };
+static_assert(alignof(C) == 8);
+static_assert(sizeof(C) == 8);
+
+struct D {};
+static_assert(std::is_empty_v<D>);
+using Hybrid = HeterogeneousArray_Hybrid<int, A, C>;
+
+TEST(HeterogeneousArray_Hybrid, dispatch)
+{
+    static_assert(Hybrid::is_static<int>);
+    static_assert(Hybrid::is_static<const A&>);
+    static_assert(!Hybrid::is_static<double>);
+
+    Hybrid container;
+    container.insert(5);
+    container.insert(A{ 3 });
+    //↓ static types never reach the dynamic region
+    EXPECT_EQ(container.dynamic.types.size(), 0);
+    EXPECT_EQ(container.dynamic.data.size(), 0);
+    container.insert(2.5);
+    EXPECT_EQ(container.dynamic.types.size(), 1);
+    EXPECT_EQ(&container.get<int>(), &container.fixed.get<int>());
+    EXPECT_EQ(&container.get<double>(), &container.dynamic.get<double>());
+}
+
+TEST(HeterogeneousArray_Hybrid, insert_all)
+{
+    Hybrid container;
+    {// only static types
+        auto&& [i, a] = container.insert(int{ 1 }, A{ 2 });
+        EXPECT_EQ(i, 1);
+        EXPECT_EQ(a.x, 2);
+    }
+    {// only dynamic types
+        auto&& [d, b] = container.insert(double{ 3 }, B{ 4. });
+        EXPECT_EQ(d, 3);
+        EXPECT_EQ(b.x, 4);
+    }
+    {// mix of both
+        auto&& [c, f] = container.insert(C{ 5 }, float{ 6 });
+        EXPECT_EQ(c.v, 5);
+        EXPECT_EQ(f, 6);
+    }
+    struct empty_1 {};
+    struct empty_2 {};
+    container.insert(empty_1{}, empty_2{});
+    EXPECT_EQ((container.contains<empty_1, empty_2>()), true);
+    EXPECT_EQ((container.contains<int, A, C, double, B, float>()), true);
+}
+
+TEST(HeterogeneousArray_Hybrid, get)
+{
+    Hybrid container;
+    container.insert(42, 3.14, C{ 7 });
+    auto&& [i, d, c] = container.get<int, double, C>();
+    static_assert(std::is_same_v<decltype(i), int&>);
+    static_assert(std::is_same_v<decltype(d), double&>);
+    static_assert(std::is_same_v<decltype(c), C&>);
+    EXPECT_EQ(i, 42);
+    EXPECT_EQ(d, 3.14);
+    EXPECT_EQ(c.v, 7);
+    const Hybrid& const_container = container;
+    auto&& ci = const_container.get<const int>();
+    static_assert(std::is_same_v<decltype(ci), const int&>);
+    EXPECT_EQ(ci, 42);
+}
+
+TEST(HeterogeneousArray_Hybrid, contains)
+{
+    Hybrid container;
+    container.insert(A{});
+    container.insert(5.);
+    EXPECT_EQ(container.contains<A>(), true);
+    EXPECT_EQ(container.contains<double>(), true);
+    EXPECT_EQ(container.contains<int>(), false);
+    EXPECT_EQ(container.contains<B>(), false);
+    EXPECT_EQ((container.contains<A, double>()), true);
+    EXPECT_EQ((container.contains<A, B>()), false);
+    EXPECT_EQ(container.contains(type_id<A>()), true);
+    EXPECT_EQ(container.contains(type_id<double>()), true);
+    EXPECT_EQ(container.has<int>(), nullptr);
+    EXPECT_EQ(container.has<B>(), nullptr);
+    EXPECT_EQ(container.has<double>(), &container.get<double>());
+}
+
+TEST(HeterogeneousArray_Hybrid, assign_destruct)
+{
+    Hybrid container;
+    container.insert_or_assign(1, 2.);
+    container.insert_or_assign<int>(3);
+    container.insert_or_assign<double>(4.);
+    EXPECT_EQ(container.get<int>(), 3);
+    EXPECT_EQ(container.get<double>(), 4.);
+    container.destruct<int, double>();
+    EXPECT_EQ(container.contains<int>(), false);
+    EXPECT_EQ(container.contains<double>(), false);
+    container.assign(5, 6.);
+    EXPECT_EQ(container.get<int>(), 5);
+    EXPECT_EQ(container.get<double>(), 6.);
+    container.clear();
+    EXPECT_EQ((container.contains<int>() || container.contains<double>()), false);
+}
+
+TEST(HeterogeneousArray_Hybrid, move_container)
+{
+    using vec = std::vector<int>;
+    HeterogeneousArray_Hybrid<vec> a;
+    a.insert(vec{ 5,25 });
+    a.insert(std::string("dynamic"));
+    HeterogeneousArray_Hybrid<vec> b{ std::move(a) };
+    EXPECT_EQ(b.get<vec>()[1], 25);
+    EXPECT_EQ(b.get<std::string>(), "dynamic");
+    EXPECT_EQ(a.contains<vec>(), false);
+    EXPECT_EQ(a.contains<std::string>(), false);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
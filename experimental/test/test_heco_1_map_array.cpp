@@ -1,4 +1,10 @@
 ﻿#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+//↓ records the addresses the containers ask to prefetch
+static std::vector<const void*> prefetched;
+#define HECO_PREFETCH(address) prefetched.push_back(static_cast<const void*>(address))
 
 #undef NDEBUG
 #define protected public
@@ -11,8 +17,8 @@ using namespace heco;
 
 struct A
 {
-    int x;
-    char c;
+    int x = 0;
+    char c = 0;
     ~A() {};
 };
 static_assert(std::is_trivially_destructible_v < A > == false);
@@ -21,9 +27,9 @@ static_assert(sizeof(A) == 8);
 
 struct B
 {
-    double x;
-    int y[4];
-    A z;
+    double x = 0;
+    int y[4] = {};
+    A z{};
 };
 static_assert(std::is_trivially_destructible_v < B > == false);
 
@@ -183,6 +189,41 @@ TEST(HeterogeneousArray, get_from_offset)
     EXPECT_EQ(vi, X01);
 }
 
+TEST(HeterogeneousArray, view)
+{
+    double X00 = 5.63454;
+    int X01 = 218762532;
+
+    HeterogeneousArray container;
+    container.insert(X00, X01);
+    auto view = container.view<int, double>();
+    EXPECT_TRUE(view.valid());
+    EXPECT_EQ(view.get<0>(), X01);
+    EXPECT_EQ(view.get<double>(), X00);
+    auto [vi, vd] = view;
+    static_assert(std::is_same_v<decltype(vi), int&>);
+    static_assert(std::is_same_v<decltype(vd), double&>);
+    vi = 7;
+    EXPECT_EQ(container.get<int>(), 7);
+    auto&& [ti, td] = view.tuple();
+    EXPECT_EQ(&ti, &container.get<int>());
+    EXPECT_EQ(&td, &container.get<double>());
+    //↓ offsets survive reallocation of the buffer
+    container.insert(std::array<char, 1000>{});
+    EXPECT_TRUE(view.valid());
+    EXPECT_EQ(view.get<int>(), 7);
+    EXPECT_EQ(view.get<double>(), X00);
+    //↓ removing an object invalidates the views made before
+    container.destruct<std::array<char, 1000>>();
+    EXPECT_FALSE(view.valid());
+    ASSERT_DEATH(view.get<int>(), "");
+    auto const_view = std::as_const(container).view<const int>();
+    static_assert(std::is_same_v<decltype(const_view.get<0>()), const int&>);
+    EXPECT_EQ(const_view.get<0>(), 7);
+    container.clear();
+    EXPECT_FALSE(const_view.valid());
+}
+
 TEST(HeterogeneousArray, contains)
 {
     double X00 = 5.63454f;
@@ -262,20 +303,23 @@ TEST(HeterogeneousArray, const_access)
 TEST(HeterogeneousArray, non_trivially_destructible)
 {
     HeterogeneousArray container;
-    EXPECT_EQ(container.destructors.size(), 0);
+    auto constructed = [&container]() {
+        return std::count_if(container.metadata.begin(), container.metadata.end(), [](auto& m) { return m.flags & HeterogeneousArray::CONSTRUCTED; });
+    };
+    EXPECT_EQ(constructed(), 0);
     container.insert(A{});
-    EXPECT_EQ(container.destructors.size(), 1);
+    EXPECT_EQ(constructed(), 1);
     container.insert(1.f);
-    EXPECT_EQ(container.destructors.size(), 2);
+    EXPECT_EQ(constructed(), 2);
     container.insert<B>();
-    EXPECT_EQ(container.destructors.size(), 3);
+    EXPECT_EQ(constructed(), 3);
 
     container.destruct<A>();
-    EXPECT_EQ(container.destructors.size(), 2);
+    EXPECT_EQ(constructed(), 2);
     container.destruct<B>();
-    EXPECT_EQ(container.destructors.size(), 1);
+    EXPECT_EQ(constructed(), 1);
     container.destruct<float>();
-    EXPECT_EQ(container.destructors.size(), 0);
+    EXPECT_EQ(constructed(), 0);
 
     container.assign(A{});
     container.assign(1.f);
@@ -317,6 +361,19 @@ TEST(HeterogeneousArray, aligned_allocation)
     }
 }
 
+TEST(HeterogeneousArray, packing_table)
+{
+    using table = packing_table<char, A, C, double, short>;
+    static_assert(table::alignment == 8);
+    static_assert(table::layouts.size() == 8);
+    static_assert(table::at(64).size == table::layouts[0].size);
+    for (std::uintptr_t end = 0; end < 16; ++end) {
+        const auto layout = pack<5>({ alignof(char), alignof(A), alignof(C), alignof(double), alignof(short) }, { sizeof(char), sizeof(A), sizeof(C), sizeof(double), sizeof(short) }, end);
+        EXPECT_EQ(table::at(end).offsets, layout.offsets);
+        EXPECT_EQ(table::at(end).size, layout.size);
+    }
+}
+
 TEST(HeterogeneousArray, empty_type)
 {
     struct D {};
@@ -326,11 +383,11 @@ TEST(HeterogeneousArray, empty_type)
 
     HeterogeneousArray container;
     container.insert(D{});
-    EXPECT_EQ(container.offsets.size(), 1);
+    EXPECT_EQ(container.types.size(), 1);
     container.insert(D{});
-    EXPECT_EQ(container.offsets.size(), 1);
+    EXPECT_EQ(container.types.size(), 1);
     container.insert(A{});
-    EXPECT_EQ(container.offsets.size(), 2);
+    EXPECT_EQ(container.types.size(), 2);
     ASSERT_DEATH(container.insert(A{}), "");
     EXPECT_EQ(container.contains<D>(), true);
     EXPECT_EQ(container.contains<A>(), true);
@@ -366,6 +423,346 @@ TEST(HeterogeneousArray, move_container)
     EXPECT_EQ(b.get<int>(), 42);
 }
 
+struct SelfReferencing
+{
+    SelfReferencing* self = this;
+    SelfReferencing() = default;
+    SelfReferencing(SelfReferencing&&) noexcept {}
+};
+static_assert(is_trivially_relocatable_v<SelfReferencing> == false);
+
+struct Relocatable
+{
+    static inline int moves = 0;
+    int v = 0;
+    Relocatable() = default;
+    Relocatable(Relocatable&& other) noexcept : v(other.v) { ++moves; }
+};
+template<> struct heco::is_trivially_relocatable<Relocatable> : std::true_type {};
+
+TEST(HeterogeneousArray, relocation)
+{
+    HeterogeneousArray container;
+    container.insert(SelfReferencing{});
+    container.insert(std::string("short"));
+    container.insert(Relocatable{});
+    Relocatable::moves = 0;
+    auto capacity = container.data.capacity();
+    auto storage = container.data.data();
+    //↓ force several reallocations
+    container.insert(std::array<char, 100>{});
+    container.insert(std::array<char, 1000>{}, std::array<char, 10000>{});
+    container.reserve(100000);
+    EXPECT_NE(container.data.data(), storage);
+    EXPECT_GT(container.data.capacity(), capacity);
+    auto& s = container.get<SelfReferencing>();
+    EXPECT_EQ(s.self, &s);
+    EXPECT_EQ(container.get<std::string>(), "short");
+    container.get<std::string>() += " string now longer than the small buffer";
+    EXPECT_EQ(container.get<std::string>(), "short string now longer than the small buffer");
+    //↓ types opted in through the trait are copied bytewise
+    EXPECT_EQ(Relocatable::moves, 0);
+}
+
+TEST(HeterogeneousArray_Segmented, pointer_stability)
+{
+    using Segments = segmented_bytes;
+    HeterogeneousArray_Segmented container;
+    auto& s = container.insert(std::string("short"));
+    auto& a = container.insert(A{ 5, 'a' });
+    auto [c, i] = container.insert(C{ 8 }, 42);
+    EXPECT_EQ(Segments::segment_of(container.offset_of<std::string>()), 0);
+    //↓ a type which does not fit in the chunk goes to a fresh one
+    auto& big = container.insert(std::array<char, 10000>{});
+    EXPECT_EQ(Segments::segment_of(container.offset_of<std::array<char, 10000>>()), 1);
+    EXPECT_EQ(std::uintptr_t(&big) % default_alignment, 0);
+    container.insert(std::array<int, 16>{});
+    container.insert(B{});
+    //↓ earlier references still point to the objects
+    EXPECT_EQ(&s, &container.get<std::string>());
+    EXPECT_EQ(&a, &container.get<A>());
+    EXPECT_EQ(&c, &container.get<C>());
+    EXPECT_EQ(&i, &container.get<int>());
+    EXPECT_EQ(s, "short");
+    EXPECT_EQ(a.x, 5);
+    EXPECT_EQ(c.v, 8);
+    EXPECT_EQ(i, 42);
+    EXPECT_GE(container.data.capacity(), container.data.size());
+    auto [vs, vi] = container.view<std::string, int>();
+    EXPECT_EQ(&vs, &s);
+    EXPECT_EQ(&vi, &i);
+    container.destruct<A>();
+    EXPECT_FALSE(container.contains<A>());
+    EXPECT_TRUE(container.contains<std::string>());
+    //↓ moving the container keeps the objects in place
+    HeterogeneousArray_Segmented moved{ std::move(container) };
+    EXPECT_EQ(&moved.get<std::string>(), &s);
+    EXPECT_ANY_THROW(container.get<std::string>());
+    EXPECT_EQ(container.data.capacity(), 0);
+    moved.clear();
+    EXPECT_EQ(moved.data.size(), 0);
+    moved.insert(3.0);
+    EXPECT_EQ(moved.get<double>(), 3.0);
+}
+
+TEST(HeterogeneousArray_Segmented, reserve)
+{
+    HeterogeneousArray_Segmented container;
+    container.reserve(1 << 12);
+    EXPECT_GE(container.data.available(), 1 << 12);
+    auto& x = container.insert(std::array<char, 1 << 11>{});
+    auto& y = container.insert(std::array<int, 1 << 9>{});
+    EXPECT_EQ(segmented_bytes::segment_of(container.offset_of<std::array<int, 1 << 9>>()), 0);
+    EXPECT_EQ(reinterpret_cast<std::byte*>(&x) + sizeof(x), reinterpret_cast<std::byte*>(&y));
+}
+
+TEST(HeterogeneousArray, erase)
+{
+    HeterogeneousArray container;
+    container.insert(std::string("first"), A{ 1, 'a' }, 2.0);
+    const auto size = container.data.size();
+    const auto offset_string = container.offset_of<std::string>();
+    container.erase<std::string>();
+    EXPECT_FALSE(container.is_allocated<std::string>());
+    EXPECT_EQ(container.types.size(), 2);
+    EXPECT_EQ(container.get<A>().x, 1);
+    //↓ a type of the same size and alignment takes the slot back
+    using S = std::array<char, sizeof(std::string)>;
+    container.insert(S{ 'x' });
+    EXPECT_EQ(container.offset_of<S>(), offset_string);
+    EXPECT_EQ(container.data.size(), size);
+    EXPECT_TRUE(container.holes.empty());
+    //↓ bulk insertion takes the holes it can and packs the others
+    container.erase<A, double>();
+    container.insert(C{ 3 }, 4.0, 5);
+    EXPECT_EQ(container.get<C>().v, 3);
+    EXPECT_EQ(container.get<double>(), 4.0);
+    EXPECT_EQ(container.get<int>(), 5);
+    EXPECT_EQ(container.get<S>()[0], 'x');
+    //↓ empty types have no slot
+    struct D {};
+    container.insert(D{});
+    container.erase<D>();
+    EXPECT_FALSE(container.contains<D>());
+    ASSERT_DEATH(container.erase<D>(), "");
+}
+
+template<std::size_t N>
+using Bytes = std::array<char, N>;
+
+TEST(HeterogeneousArray, erase_holes)
+{
+    HeterogeneousArray container;
+    container.insert(Bytes<16>{});
+    container.insert(Bytes<32>{});
+    container.insert(Bytes<64>{});
+    container.insert(42);
+    const auto size = container.data.size();
+    const auto offset_16 = container.offset_of<Bytes<16>>();
+    const auto offset_32 = container.offset_of<Bytes<32>>();
+    //↓ a smaller type takes a larger hole, the rest stays available
+    container.erase<Bytes<32>>();
+    container.insert(Bytes<24>{});
+    EXPECT_EQ(container.offset_of<Bytes<24>>(), offset_32);
+    ASSERT_EQ(container.holes.size(), 1);
+    EXPECT_EQ(container.holes[0].size, 8);
+    //↓ neighbouring holes merge
+    container.erase<Bytes<16>, Bytes<24>>();
+    ASSERT_EQ(container.holes.size(), 1);
+    EXPECT_EQ(container.holes[0].offset, offset_16);
+    EXPECT_EQ(container.holes[0].size, 48);
+    //↓ churn of various sizes keeps the list and the buffer bounded
+    for (int i = 0; i < 100; ++i) {
+        container.insert(Bytes<8>{}, Bytes<20>{});
+        container.erase<Bytes<8>>();
+        container.insert(Bytes<12>{});
+        container.erase<Bytes<20>, Bytes<12>>();
+    }
+    EXPECT_EQ(container.holes.size(), 1);
+    EXPECT_EQ(container.data.size(), size);
+    EXPECT_EQ(container.get<int>(), 42);
+}
+
+TEST(HeterogeneousArray, compact)
+{
+    HeterogeneousArray container;
+    container.insert(std::string("long enough not to fit in the small buffer"));
+    container.insert(SelfReferencing{});
+    container.insert(std::array<char, 1000>{});
+    container.insert('c');
+    container.insert(std::array<char, 2000>{});
+    container.insert(42);
+    container.erase<std::array<char, 1000>, std::array<char, 2000>>();
+    auto view = container.view<int>();
+    const auto capacity = container.data.capacity();
+    const auto reclaimed = container.compact();
+    EXPECT_GT(reclaimed, 3000);
+    EXPECT_EQ(container.data.capacity(), capacity - reclaimed);
+    EXPECT_EQ(container.data.size(), sizeof(std::string) + sizeof(SelfReferencing) + sizeof(int) + sizeof(char));
+    EXPECT_FALSE(view.valid());
+    EXPECT_EQ(container.get<std::string>(), "long enough not to fit in the small buffer");
+    auto& s = container.get<SelfReferencing>();
+    EXPECT_EQ(s.self, &s);
+    EXPECT_EQ(container.get<char>(), 'c');
+    EXPECT_EQ(container.get<int>(), 42);
+    EXPECT_EQ(container.compact(), 0);
+}
+
+TEST(HeterogeneousArray, compact_resource)
+{
+    struct counting_resource : std::pmr::memory_resource {
+        std::size_t allocations = 0;
+        void* do_allocate(std::size_t n, std::size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(n, alignment);
+        }
+        void do_deallocate(void* p, std::size_t n, std::size_t alignment) override { std::pmr::new_delete_resource()->deallocate(p, n, alignment); }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    } counting;
+    HeterogeneousArray container(&counting);
+    container.insert(A{ 1, 'a' }, std::array<char, 100>{}, 2.0);
+    container.erase<std::array<char, 100>>();
+    //↓ the new buffer and the five scratch tables
+    const auto allocations = counting.allocations;
+    EXPECT_GT(container.compact(), 0);
+    EXPECT_EQ(counting.allocations, allocations + 6);
+    EXPECT_EQ(container.get<A>().x, 1);
+    EXPECT_EQ(container.get<double>(), 2.0);
+}
+
+TEST(HeterogeneousArray_Segmented, compact)
+{
+    HeterogeneousArray_Segmented container;
+    container.insert(std::string("text"));
+    container.insert(std::array<char, 10000>{});
+    container.insert(std::array<char, 20000>{});
+    container.insert(7);
+    container.erase<std::array<char, 10000>, std::array<char, 20000>>();
+    EXPECT_GT(container.compact(), 0);
+    EXPECT_EQ(segmented_bytes::segment_of(container.offset_of<int>()), 0);
+    EXPECT_EQ(container.get<std::string>(), "text");
+    EXPECT_EQ(container.get<int>(), 7);
+}
+
+template<typename Container>
+void check_memory_resource()
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    {
+        Container container(&arena);
+        EXPECT_EQ(container.resource(), &arena);
+        container.insert(A{ 7, 'a' }, C{ 7 });
+        //↓ grow a few times
+        container.insert(std::array<char, 100>{});
+        container.insert(std::array<char, 200>{});
+        container.insert(std::array<char, 300>{}, 3.0);
+        EXPECT_TRUE(inside(&container.template get<std::array<char, 300>>()));
+        EXPECT_TRUE(inside(container.types.data()));
+        EXPECT_TRUE(inside(container.metadata.data()));
+        EXPECT_EQ(container.template get<C>().v, 7);
+        EXPECT_EQ(std::uintptr_t(&container.template get<C>()) % alignof(C), 0);
+        //↓ the storage and its resource go along when moving
+        Container other;
+        other = std::move(container);
+        EXPECT_EQ(other.resource(), &arena);
+        EXPECT_TRUE(inside(&other.template get<double>()));
+        EXPECT_EQ(other.template get<A>().x, 7);
+    }
+    Container container;
+    EXPECT_EQ(container.resource(), std::pmr::get_default_resource());
+}
+
+TEST(HeterogeneousArray, memory_resource)
+{
+    check_memory_resource<HeterogeneousArray>();
+}
+
+TEST(HeterogeneousArray_Segmented, memory_resource)
+{
+    check_memory_resource<HeterogeneousArray_Segmented>();
+}
+
+TEST(HeterogeneousArray_Small, memory_resource)
+{
+    check_memory_resource<HeterogeneousArray_Small<64>>();
+}
+
+//↓ count heap allocations made through operator new
+static std::size_t allocations = 0;
+void* operator new(std::size_t n) {
+    ++allocations;
+    if (void* p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+TEST(HeterogeneousArray_Small, no_allocation)
+{
+    using Small = HeterogeneousArray_Small<128>;
+    const auto allocations_before = allocations;
+    {
+        Small container;
+        container.insert(A{ 1, 'a' }, C{ 2 }, 3.0);
+        container.insert(SelfReferencing{});
+        container.insert<int>(4);
+        container.erase<int>();
+        container.insert<float>(5.f);
+        EXPECT_TRUE(container.data.is_inline());
+        EXPECT_EQ(container.get<A>().x, 1);
+        EXPECT_EQ(container.get<C>().v, 2);
+        EXPECT_EQ(container.get<double>(), 3.0);
+        EXPECT_EQ(container.get<float>(), 5.f);
+        auto& s = container.get<SelfReferencing>();
+        EXPECT_EQ(s.self, &s);
+    }
+    EXPECT_EQ(allocations, allocations_before);
+}
+
+TEST(HeterogeneousArray_Small, spill)
+{
+    using Small = HeterogeneousArray_Small<64>;
+    Small container;
+    container.insert(std::string("short"), SelfReferencing{});
+    EXPECT_TRUE(container.data.is_inline());
+    container.insert(std::array<char, 100>{});
+    EXPECT_FALSE(container.data.is_inline());
+    EXPECT_EQ(std::uintptr_t(container.data.data()) % default_alignment, 0);
+    EXPECT_EQ(container.get<std::string>(), "short");
+    auto& s = container.get<SelfReferencing>();
+    EXPECT_EQ(s.self, &s);
+    //↓ back inside once compacted
+    container.erase<std::array<char, 100>>();
+    EXPECT_GT(container.compact(), 0);
+    EXPECT_TRUE(container.data.is_inline());
+    EXPECT_EQ(container.get<std::string>(), "short");
+    EXPECT_EQ(container.get<SelfReferencing>().self, &container.get<SelfReferencing>());
+}
+
+TEST(HeterogeneousArray_Small, move)
+{
+    using Small = HeterogeneousArray_Small<64>;
+    Small a;
+    a.insert(std::string("short"), SelfReferencing{}, 42);
+    Small b{ std::move(a) };
+    EXPECT_TRUE(b.data.is_inline());
+    EXPECT_EQ(b.get<std::string>(), "short");
+    EXPECT_EQ(b.get<SelfReferencing>().self, &b.get<SelfReferencing>());
+    EXPECT_EQ(b.get<int>(), 42);
+    EXPECT_FALSE(a.contains<int>());
+    EXPECT_EQ(a.data.size(), 0);
+    Small c;
+    c.insert(std::array<char, 100>{});
+    c = std::move(b);
+    EXPECT_EQ(c.get<std::string>(), "short");
+    EXPECT_EQ(c.get<SelfReferencing>().self, &c.get<SelfReferencing>());
+    EXPECT_FALSE((c.contains<std::array<char, 100>>()));
+}
+
 TEST(HeterogeneousArray, reserve_construct)
 {
     struct A { int a = 404; };
@@ -379,6 +776,78 @@ TEST(HeterogeneousArray, reserve_construct)
     EXPECT_EQ(b.b, 42);
 }
 
+TEST(HeterogeneousArray, gather)
+{
+    std::vector<HeterogeneousArray> arrays(40);
+    for (int i = 0; i < 40; ++i) {
+        //↓ two layouts, and containers without B
+        if (i % 2)
+            arrays[i].insert(C{ i }, A{ i, 'a' });
+        else
+            arrays[i].insert(A{ i, 'a' }, C{ i });
+        if (i % 5)
+            arrays[i].insert(B{ double(i) });
+    }
+    std::vector<HeterogeneousArray*> pointers;
+    for (auto& a : arrays)
+        pointers.push_back(&a);
+
+    std::vector<A*> as;
+    std::vector<const B*> bs;
+    std::vector<C> cs;
+    C out[40];
+    HeterogeneousArray::gather<A, B, C>(pointers.begin(), pointers.end(), std::back_inserter(as), std::back_inserter(bs), std::back_inserter(cs));
+    ASSERT_EQ(as.size(), 40);
+    ASSERT_EQ(bs.size(), 40);
+    ASSERT_EQ(cs.size(), 40);
+    for (int i = 0; i < 40; ++i) {
+        //↓ pointers to the objects, copies of them
+        EXPECT_EQ(as[i], &arrays[i].get<A>());
+        EXPECT_EQ(bs[i], arrays[i].has<B>());
+        EXPECT_EQ(bs[i] == nullptr, i % 5 == 0);
+        EXPECT_EQ(cs[i].v, i);
+    }
+    auto [end] = HeterogeneousArray::gather<C>(pointers.data() + 10, pointers.data() + 20, out);
+    EXPECT_EQ(end, out + 10);
+    EXPECT_EQ(out[0].v, 10);
+    EXPECT_EQ(out[9].v, 19);
+}
+
+TEST(HeterogeneousArray, gather_missing_type)
+{
+    std::vector<HeterogeneousArray> arrays(3);
+    for (auto& a : arrays)
+        a.insert(A{ 1, 'a' });
+    arrays[0].insert(B{ 1. });
+    arrays[2].insert(B{ 3. });
+    std::vector<HeterogeneousArray*> pointers{ &arrays[0], &arrays[1], &arrays[2] };
+    //↓ copies cannot stand for a missing object, checked in every build mode and not by an assert
+    std::vector<B> bs;
+    EXPECT_THROW(HeterogeneousArray::gather<B>(pointers.begin(), pointers.end(), std::back_inserter(bs)), std::out_of_range);
+    ASSERT_EQ(bs.size(), 1);
+    EXPECT_EQ(bs[0].x, 1.);
+    //↓ pointers can
+    std::vector<B*> ps;
+    HeterogeneousArray::gather<B>(pointers.begin(), pointers.end(), std::back_inserter(ps));
+    EXPECT_EQ(ps[1], nullptr);
+    EXPECT_EQ(ps[2], &arrays[2].get<B>());
+    //↓ a type allocated but destroyed is missing as well
+    arrays[2].destruct<B>();
+    EXPECT_THROW(HeterogeneousArray::gather<B>(pointers.begin() + 2, pointers.end(), std::back_inserter(bs)), std::out_of_range);
+}
+
+TEST(HeterogeneousArray, prefetch)
+{
+    struct E {};
+    HeterogeneousArray c;
+    c.insert(A{ 1, 'a' }, C{ 2 });
+    c.insert(E{});
+    prefetched.clear();
+    c.prefetch<C, B, E, A>();
+    //↓ only objects held, empty ones have no address
+    EXPECT_EQ(prefetched, (std::vector<const void*>{ &c.get<C>(), &c.get<A>() }));
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
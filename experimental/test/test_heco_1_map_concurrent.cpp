@@ -0,0 +1,131 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_1_map_concurrent.h>
+#undef protected
+#undef private
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace heco;
+
+struct A { int i = 0; };
+struct B { double d = 0; };
+struct C { std::string s; };
+
+template<int I>
+struct counted {
+    static inline std::atomic<int> alive = 0;
+    int value;
+    counted(int v) : value(v) { ++alive; }
+    counted(const counted& o) : value(o.value) { ++alive; }
+    ~counted() { --alive; }
+};
+
+TEST(HeterogeneousContainer_Concurrent, insert_get)
+{
+    HeterogeneousContainer_Concurrent hc;
+    EXPECT_FALSE(hc.contains<A>());
+    EXPECT_EQ(hc.has<A>(), nullptr);
+    auto&& [a, b] = hc.insert(A{ 1 }, B{ 2. });
+    EXPECT_EQ(a.i, 1);
+    EXPECT_EQ(b.d, 2.);
+    hc.insert<C>("three");
+    EXPECT_TRUE((hc.contains<A, B, C>()));
+    EXPECT_EQ(hc.get<C>().s, "three");
+    EXPECT_EQ(&hc.get<A>(), &a);
+    //↓ the object already held wins, like HeterogeneousContainer::insert
+    A& again = hc.insert(A{ 5 });
+    EXPECT_EQ(&again, &a);
+    EXPECT_EQ(again.i, 1);
+    auto&& [ra, rc] = hc.get<const A, C>();
+    EXPECT_EQ(ra.i, 1);
+    EXPECT_EQ(rc.s, "three");
+    const HeterogeneousContainer_Concurrent& chc = hc;
+    EXPECT_EQ(chc.has<const B>(), &b);
+}
+
+TEST(HeterogeneousContainer_Concurrent, destructor)
+{
+    {
+        HeterogeneousContainer_Concurrent hc;
+        hc.insert<counted<0>>(1);
+        hc.insert(counted<1>{ 2 });
+        EXPECT_EQ(counted<0>::alive, 1);
+        EXPECT_EQ(counted<1>::alive, 1);
+    }
+    EXPECT_EQ(counted<0>::alive, 0);
+    EXPECT_EQ(counted<1>::alive, 0);
+}
+
+template<int I>
+struct tagged { int value = I; int copy = I; };
+
+template<int... I>
+void race(std::integer_sequence<int, I...>)
+{
+    constexpr int n_threads = 8;
+    HeterogeneousContainer_Concurrent hc;
+    std::atomic<bool> go = false;
+    std::vector<std::vector<const void*>> seen(n_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t] {
+            while (!go.load()) {}
+            //↓ half of the threads write, the other half read until every type shows up
+            if (t % 2 == 0) {
+                (seen[t].push_back(&hc.insert<tagged<I>>()), ...);
+                seen[t].push_back(&hc.insert<counted<2>>(t));
+            }
+            else {
+                (seen[t].push_back([&] {
+                    tagged<I>* p = nullptr;
+                    while (!(p = hc.has<tagged<I>>())) {}
+                    //↓ published objects are fully constructed
+                    EXPECT_EQ(p->value, I);
+                    EXPECT_EQ(p->copy, I);
+                    return p;
+                }()), ...);
+            }
+        });
+    go = true;
+    for (auto& thread : threads)
+        thread.join();
+    //↓ every thread saw the same object for each type
+    for (int t = 0; t < n_threads; t += 2)
+        EXPECT_EQ(seen[t], seen[0]);
+    for (int t = 1; t < n_threads; t += 2)
+        for (std::size_t i = 0; i < sizeof...(I); ++i)
+            EXPECT_EQ(seen[t][i], seen[0][i]);
+    EXPECT_TRUE(hc.contains<tagged<I>...>());
+    //↓ objects of losing threads were destroyed
+    EXPECT_EQ(counted<2>::alive, 1);
+}
+
+TEST(HeterogeneousContainer_Concurrent, stress)
+{
+    for (int run = 0; run < 50; ++run) {
+        race(std::make_integer_sequence<int, 300>{});
+        EXPECT_EQ(counted<2>::alive, 0);
+    }
+}
+
+TEST(HeterogeneousContainer_Concurrent, too_many_types)
+{
+    HeterogeneousContainer_Concurrent hc;
+    //↓ ids past the directory of pages are reported instead of indexing past it
+    EXPECT_THROW(hc.slot(HeterogeneousContainer_Concurrent::max_types), std::length_error);
+    EXPECT_EQ(hc.find(HeterogeneousContainer_Concurrent::max_types), nullptr);
+    EXPECT_NO_THROW(hc.slot(HeterogeneousContainer_Concurrent::max_types - 1));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
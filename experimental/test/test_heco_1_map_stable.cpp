@@ -1,4 +1,9 @@
 ﻿#include <gtest/gtest.h>
+#include <vector>
+
+//↓ records the addresses the containers ask to prefetch
+static std::vector<const void*> prefetched;
+#define HECO_PREFETCH(address) prefetched.push_back(static_cast<const void*>(address))
 
 #undef NDEBUG
 #define protected public
@@ -11,8 +16,8 @@ using namespace heco;
 
 struct A
 {
-    int x;
-    char c;
+    int x = 0;
+    char c = 0;
     ~A() {};
 };
 static_assert(std::is_trivially_destructible_v < A > == false);
@@ -21,9 +26,9 @@ static_assert(sizeof(A) == 8);
 
 struct B
 {
-    double x;
-    int y[4];
-    A z;
+    double x = 0;
+    int y[4] = {};
+    A z{};
 };
 static_assert(std::is_trivially_destructible_v < B > == false);
 
@@ -274,6 +279,121 @@ TEST(HeterogeneousContainer, destruction)
     EXPECT_EQ(test_mv_dtor::destroyed, true);
 }
 
+struct counted
+{
+    counted() { ++alive; }
+    counted(const counted&) { ++alive; }
+    ~counted() { --alive; }
+    static inline int alive = 0;
+};
+
+TEST(HeterogeneousContainer, memory_resource)
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    {
+        HeterogeneousContainer container(&arena);
+        EXPECT_EQ(container.resource(), &arena);
+        auto&& [a, c, d] = container.insert(A{ 1, 'a' }, C{ 2 }, 3.0);
+        EXPECT_TRUE(inside(&a) && inside(&c) && inside(&d));
+        EXPECT_EQ(std::uintptr_t(&c) % alignof(C), 0);
+        container.insert_or_assign(C{ 4 });
+        EXPECT_TRUE(inside(&container.get<C>()));
+        EXPECT_EQ(container.get<C>().v, 4);
+        container.insert<counted>();
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(HeterogeneousContainer, pooled)
+{
+    using pool = slab_pool_of<B>;
+    const B* first = nullptr;
+    {
+        HeterogeneousContainer container(pooled);
+        first = &container.insert(B{ 1.5 });
+        container.insert<counted>();
+        EXPECT_EQ(std::uintptr_t(first) % alignof(B), 0);
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+    const auto capacity = pool::instance().capacity();
+    const auto available = pool::instance().available();
+    //↓ slots go back to the pool and are handed out again, to any container
+    {
+        HeterogeneousContainer container(pooled);
+        EXPECT_EQ(&container.insert(B{ 2.5 }), first);
+        HeterogeneousContainer other(pooled);
+        auto& b = other.insert(B{ 3.5 });
+        EXPECT_EQ(pool::instance().available(), available - 2);
+        EXPECT_EQ(std::abs(reinterpret_cast<const std::byte*>(&b) - reinterpret_cast<const std::byte*>(first)) % pool::slot_size, 0);
+        container = std::move(other);
+        EXPECT_EQ(&container.get<B>(), &b);
+        EXPECT_EQ(container.get<B>().x, 3.5);
+    }
+    EXPECT_EQ(pool::instance().capacity(), capacity);
+    EXPECT_EQ(pool::instance().available(), available);
+}
+
+struct counting_resource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    void* do_allocate(std::size_t n, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(n, alignment);
+    }
+    void do_deallocate(void* p, std::size_t n, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+TEST(HeterogeneousContainer, bulk_insert)
+{
+    counting_resource counting;
+    {
+        HeterogeneousContainer container(&counting);
+        auto&& [a, c, k] = container.insert(A{ 1, 'a' }, C{ 2 }, counted{});
+        //↓ all in one block laid out by pack()
+        using block = packed_block<A, C, counted>;
+        const auto [low, high] = std::minmax({ std::uintptr_t(&a), std::uintptr_t(&c), std::uintptr_t(&k) });
+        EXPECT_LT(high - low, block::size);
+        EXPECT_EQ(std::uintptr_t(&c) % alignof(C), 0);
+        EXPECT_EQ(a.x, 1);
+        EXPECT_EQ(c.v, 2);
+        EXPECT_EQ(counted::alive, 1);
+        //↓ the block is freed with the last object living in it
+        const auto deallocations = counting.deallocations;
+        container.insert_or_assign(A{ 3, 'b' });
+        container.insert_or_assign(C{ 4 });
+        EXPECT_EQ(counting.deallocations, deallocations);
+        container.insert_or_assign(counted{});
+        EXPECT_EQ(counting.deallocations, deallocations + 1);
+        EXPECT_EQ(counted::alive, 1);
+        EXPECT_EQ(container.get<C>().v, 4);
+        //↓ types already present are not replaced
+        auto&& [a2, d] = container.insert(A{ 5, 'c' }, 6.0);
+        EXPECT_EQ(a2.x, 3);
+        EXPECT_EQ(d, 6.0);
+    }
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_EQ(counting.allocations, counting.deallocations);
+}
+
+TEST(HeterogeneousContainer, prefetch)
+{
+    HeterogeneousContainer c;
+    c.insert(A{ 1, 'a' }, C{ 2 });
+    prefetched.clear();
+    c.prefetch<C, B, A>();
+    EXPECT_EQ(prefetched, (std::vector<const void*>{ &c.get<C>(), &c.get<A>() }));
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,235 @@
+﻿#include <gtest/gtest.h>
+#include <thread>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_1_shared_array.h>
+#undef protected
+#undef private
+
+using namespace heco;
+
+struct A
+{
+    int x = 0;
+    char c = 0;
+    ~A() {};
+};
+static_assert(std::is_trivially_destructible_v < A > == false);
+static_assert(alignof(A) == 4);
+static_assert(sizeof(A) == 8);
+
+struct B
+{
+    double x = 0;
+    int y[4] = {};
+    A z{};
+};
+static_assert(std::is_trivially_destructible_v < B > == false);
+
+struct alignas(8) C { int v; };
+static_assert(alignof(C) == 8);
+static_assert(sizeof(C) == 8);
+
+struct D {};
+static_assert(std::is_empty_v<D>);
+struct counted {
+    counted() { ++alive; }
+    counted(const counted&) { ++alive; }
+    counted(counted&&) { ++alive; }
+    counted& operator=(const counted&) = default;
+    counted& operator=(counted&&) = default;
+    ~counted() { --alive; }
+    static inline int alive = 0;
+    int value = 0;
+};
+
+TEST(HeterogeneousArray_Shared, insert_get)
+{
+    double X00 = 5.63454;
+    int X01 = 218762532;
+
+    HeterogeneousArray_Shared container;
+    EXPECT_EQ(container.insert(X00), X00);
+    EXPECT_EQ(container.insert(X01), X01);
+    EXPECT_EQ(container.insert<float>(), 0);
+    auto&& [c, a, b] = container.insert(char{ 'a' }, A{ 1 }, B{ 2. });
+    EXPECT_EQ(c, 'a');
+    EXPECT_EQ(a.x, 1);
+    EXPECT_EQ(b.x, 2.);
+    auto&& [vd, vi] = container.get<double, int>();
+    static_assert(std::is_same_v<decltype(vd), double&>);
+    static_assert(std::is_same_v<decltype(vi), int&>);
+    EXPECT_EQ(vd, X00);
+    EXPECT_EQ(vi, X01);
+    EXPECT_EQ(container.get<B>().x, 2.);
+    const auto& const_container = container;
+    auto&& v = const_container.get<const double>();
+    static_assert(std::is_same_v<decltype(v), const double&>);
+    EXPECT_EQ(container.has<C>(), nullptr);
+    EXPECT_EQ(container.has<A>(), &container.get<A>());
+}
+
+TEST(HeterogeneousArray_Shared, same_offsets_as_HeterogeneousArray)
+{
+    HeterogeneousArray reference;
+    reference.insert(char{ 'a' });
+    reference.insert(A{}, C{}, double{}, B{});
+    HeterogeneousArray_Shared container;
+    container.insert(char{ 'a' });
+    container.insert(A{}, C{}, double{}, B{});
+    auto expected = reference.offset_of<char, A, C, double, B>();
+    auto offsets = container.offset_of<char, A, C, double, B>();
+    for (size_t i = 0; i < offsets.size(); ++i)
+        EXPECT_EQ(offsets[i], expected[i]);
+    EXPECT_EQ(container.data.size(), reference.data.size());
+}
+
+TEST(HeterogeneousArray_Shared, shared_layout)
+{
+    HeterogeneousArray_Shared a, b, c;
+    EXPECT_EQ(a.shared_layout(), Layout::empty());
+    a.insert(1, 2.);
+    b.insert(1, 2.);
+    EXPECT_EQ(a.shared_layout(), b.shared_layout());
+    EXPECT_EQ(a.shared_layout()->use_count(), 2);
+    //↓ different insertion order leads to another layout
+    c.insert(2.);
+    c.insert(1);
+    EXPECT_NE(a.shared_layout(), c.shared_layout());
+    //↓ state changes are transitions as well
+    a.destruct<int>();
+    EXPECT_NE(a.shared_layout(), b.shared_layout());
+    EXPECT_EQ(b.shared_layout()->use_count(), 2);//< b and the layout a transitioned to
+    b.destruct<int>();
+    EXPECT_EQ(a.shared_layout(), b.shared_layout());
+    a.assign(3);
+    b.assign(4);
+    EXPECT_EQ(a.shared_layout(), b.shared_layout());
+    EXPECT_EQ(a.get<int>(), 3);
+    EXPECT_EQ(b.get<int>(), 4);
+}
+
+TEST(HeterogeneousArray_Shared, layout_release)
+{
+    const Layout* layout = nullptr;
+    {
+        HeterogeneousArray_Shared a;
+        a.insert(std::string("unique layout"), std::vector<float>{});
+        layout = a.shared_layout();
+        EXPECT_EQ(layout->use_count(), 1);
+        HeterogeneousArray_Shared b{ std::move(a) };
+        EXPECT_EQ(a.shared_layout(), Layout::empty());
+        EXPECT_EQ(b.shared_layout(), layout);
+        EXPECT_EQ(layout->use_count(), 1);
+        HeterogeneousArray_Shared c;
+        c.insert(std::string("same layout"), std::vector<float>{});
+        EXPECT_EQ(layout->use_count(), 2);
+    }
+    //↓ unused layouts are removed from the transitions of their parent
+    HeterogeneousArray_Shared d;
+    d.insert(std::string("fresh layout"), std::vector<float>{});
+    EXPECT_EQ(d.shared_layout()->use_count(), 1);
+    EXPECT_NE(Layout::empty()->transition_to(Layout::ALLOCATE, (std::uint64_t(type_id<std::string>()) << 32) | d.offset_of<std::string>()[0]), nullptr);
+    d.clear();
+    EXPECT_EQ(Layout::empty()->children.load(), nullptr);
+}
+
+TEST(HeterogeneousArray_Shared, destruction)
+{
+    {
+        HeterogeneousArray_Shared container;
+        container.insert<counted>();
+        container.insert(A{}, C{});
+        EXPECT_EQ(counted::alive, 1);
+        container.destruct<counted>();
+        EXPECT_EQ(counted::alive, 0);
+        container.assign<counted>();
+        HeterogeneousArray_Shared other;
+        other = std::move(container);
+        EXPECT_EQ(counted::alive, 1);
+        EXPECT_EQ(container.contains<counted>(), false);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(HeterogeneousArray_Shared, empty_type)
+{
+    HeterogeneousArray_Shared container;
+    container.insert(D{});
+    container.insert(D{});
+    container.insert(A{});
+    EXPECT_EQ(container.shared_layout()->offsets.size(), 2);
+    EXPECT_EQ(container.contains<D>(), true);
+    EXPECT_EQ(container.data.size(), sizeof(A));
+    container.destruct<D>();
+    EXPECT_EQ(container.contains<D>(), false);
+}
+
+TEST(HeterogeneousArray_Shared, memory_resource)
+{
+    //↓ objects only, layouts are shared and stay on the heap
+    alignas(64) std::byte buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    {
+        HeterogeneousArray_Shared container(&arena);
+        container.insert(A{ 1, 'a' }, C{ 2 });
+        container.insert<counted>();
+        EXPECT_TRUE(inside(&container.get<A>()));
+        EXPECT_TRUE(inside(&container.get<counted>()));
+        EXPECT_EQ(container.get<C>().v, 2);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(HeterogeneousArray_Shared, relocation)
+{
+    struct large { std::byte bytes[200]; };
+    HeterogeneousArray_Shared container;
+    container.insert(std::string("short"));
+    const std::byte* before = container.data.data();
+    //↓ growing the buffer moves the string, whose small buffer would dangle after a bytewise copy
+    container.insert(large{});
+    EXPECT_NE(container.data.data(), before);
+    container.get<std::string>() += " string grown past the small buffer";
+    EXPECT_EQ(container.get<std::string>(), "short string grown past the small buffer");
+    //↓ same through an explicit reserve
+    container.reserve(4 * container.data.capacity());
+    container.get<std::string>() += "!";
+    EXPECT_EQ(container.get<std::string>(), "short string grown past the small buffer!");
+}
+
+TEST(HeterogeneousArray_Shared, concurrent_transitions)
+{
+    //↓ threads follow, create and destroy the same layouts at once
+    constexpr int n_threads = 8;
+    constexpr int n_runs = 2000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t)
+        threads.emplace_back([t] {
+            for (int i = 0; i < n_runs; ++i) {
+                HeterogeneousArray_Shared a, b;
+                a.insert(1, 2.);
+                a.insert(std::string("a"));
+                b.insert(1, 2.);
+                if ((i + t) % 2)
+                    b.insert(std::string("b"));
+                else
+                    b.insert(A{ i, 'b' });
+                EXPECT_EQ(a.get<int>(), 1);
+                EXPECT_EQ(a.get<std::string>(), "a");
+                a.destruct<int>();
+                a.clear();
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(Layout::empty()->children.load(), nullptr);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
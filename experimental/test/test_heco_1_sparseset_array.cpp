@@ -0,0 +1,306 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_1_sparseset_array.h>
+#undef protected
+#undef private
+
+using namespace heco;
+
+struct A
+{
+    int x;
+    char c;
+    ~A() {};
+};
+static_assert(std::is_trivially_destructible_v < A > == false);
+static_assert(alignof(A) == 4);
+static_assert(sizeof(A) == 8);
+
+struct B
+{
+    double x;
+    int y[4];
+    A z;
+};
+static_assert(std::is_trivially_destructible_v < B > == false);
+
+struct alignas(8) C { int v; };
+static_assert(alignof(C) == 8);
+static_assert(sizeof(C) == 8);
+
+struct counted
+{
+    counted() { ++alive; }
+    counted(const counted&) { ++alive; }
+    counted(counted&&) noexcept { ++alive; }
+    ~counted() { --alive; }
+    static inline int alive = 0;
+};
+
+template<int I>
+struct tagged { int v = I; };
+
+struct SelfReferencing
+{
+    SelfReferencing* self = this;
+    SelfReferencing() = default;
+    SelfReferencing(SelfReferencing&&) noexcept {}
+};
+static_assert(is_trivially_relocatable_v<SelfReferencing> == false);
+
+TEST(HeterogeneousContainer_SparseSet3, insert)
+{
+    double X00 = 5.63454f;
+    int X01 = 218762532;
+
+    HeterogeneousContainer_SparseSet3 container;
+    EXPECT_EQ(container.insert(X00), X00);
+    EXPECT_EQ(container.insert(X01), X01);
+    EXPECT_EQ(container.insert<float>(), 0);
+    EXPECT_EQ(container.insert<char>(), 0);
+    auto& c = container.insert(C{ 7 });
+    EXPECT_EQ(std::uintptr_t(&c) % alignof(C), 0);
+    EXPECT_EQ(container.get<double>(), X00);
+    EXPECT_EQ(container.get<C>().v, 7);
+}
+
+TEST(HeterogeneousContainer_SparseSet3, insert_all)
+{
+    HeterogeneousContainer_SparseSet3 container;
+    container.insert(char{ 'a' });
+    auto&& [a, c, d, b] = container.insert(A{ 1, 'a' }, C{ 2 }, double{ 3 }, bool{ true });
+    EXPECT_EQ(a.x, 1);
+    EXPECT_EQ(c.v, 2);
+    EXPECT_EQ(d, 3);
+    EXPECT_EQ(b, true);
+    //↓ placed with the padding-minimizing layout after the char
+    EXPECT_EQ(std::uintptr_t(&c) % alignof(C), 0);
+    EXPECT_EQ(std::uintptr_t(&d) % alignof(double), 0);
+    EXPECT_EQ(container.data.size(), 32);
+    struct empty_1 {};
+    struct empty_2 {};
+    container.insert(empty_1{}, empty_2{});
+    EXPECT_EQ(container.contains<empty_1>(), true);
+    EXPECT_EQ(container.contains<empty_2>(), true);
+}
+
+TEST(HeterogeneousContainer_SparseSet3, insert_or_assign)
+{
+    HeterogeneousContainer_SparseSet3 container;
+    {
+        auto&& c = container.insert(char{ 'a' });
+        EXPECT_EQ(c, 'a');
+    }
+    {
+        auto&& c = container.insert_or_assign<char>('b');
+        EXPECT_EQ(c, 'b');
+    }
+    {
+        auto&& d = container.insert_or_assign<double>(3.14);
+        EXPECT_EQ(d, 3.14);
+    }
+    {
+        auto&& d = container.insert_or_assign<double>(42.);
+        EXPECT_EQ(d, 42.);
+        EXPECT_EQ(container.get<double>(), 42.);
+    }
+}
+
+TEST(HeterogeneousContainer_SparseSet3, const_get)
+{
+    double X00 = 5.63454;
+    int X01 = 218762532;
+
+    HeterogeneousContainer_SparseSet3 hc;
+    hc.insert(X00);
+    hc.insert(X01);
+    const HeterogeneousContainer_SparseSet3& container = hc;
+    auto&& [vd, vi] = container.get<double, const int>();
+    static_assert(std::is_same_v<decltype(vd), double&>);
+    static_assert(std::is_same_v<decltype(vi), const int&>);
+    EXPECT_EQ(vd, X00);
+    EXPECT_EQ(vi, X01);
+    EXPECT_EQ(container.has<float>(), nullptr);
+    EXPECT_EQ(container.has<int>(), &vi);
+}
+
+TEST(HeterogeneousContainer_SparseSet3, relocation)
+{
+    HeterogeneousContainer_SparseSet3 container;
+    container.insert(SelfReferencing{});
+    container.insert(std::string("short"));
+    container.insert<counted>();
+    auto storage = container.data.data();
+    //↓ force several reallocations
+    container.insert(std::array<char, 100>{});
+    container.insert(std::array<char, 1000>{}, std::array<char, 10000>{});
+    EXPECT_NE(container.data.data(), storage);
+    auto& s = container.get<SelfReferencing>();
+    EXPECT_EQ(s.self, &s);
+    EXPECT_EQ(container.get<std::string>(), "short");
+    EXPECT_EQ(counted::alive, 1);
+    container.clear();
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(HeterogeneousContainer_SparseSet3, move_container)
+{
+    HeterogeneousContainer_SparseSet3 a;
+    using vec = std::vector<int>;
+    a.insert(vec{5,25});
+    a.insert(42);
+    HeterogeneousContainer_SparseSet3 b{std::move(a)};
+    //↓ is move valid
+    EXPECT_EQ(b.get<vec>()[0], 5);
+    EXPECT_EQ(b.get<vec>()[1], 25);
+    EXPECT_EQ(b.get<int>(), 42);
+    //↓ is original container reset
+    EXPECT_FALSE(a.contains<int>());
+    EXPECT_EQ(a.data.size(), 0);
+    //↓ are containers really dissociated
+    a.insert_or_assign(56);
+    EXPECT_EQ(b.get<int>(), 42);
+    b = std::move(a);
+    EXPECT_EQ(b.get<int>(), 56);
+    EXPECT_FALSE(b.contains<vec>());
+}
+
+TEST(HeterogeneousContainer_SparseSet3, memory_resource)
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    {
+        HeterogeneousContainer_SparseSet3 container(&arena);
+        EXPECT_EQ(container.resource(), &arena);
+        auto&& [a, c, d] = container.insert(A{ 1, 'a' }, C{ 2 }, 3.0);
+        EXPECT_TRUE(inside(&a) && inside(&c) && inside(&d));
+        container.insert<counted>();
+        EXPECT_TRUE(inside(&container.get<counted>()));
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(HeterogeneousContainer_SparseSet3, reallocate_resource)
+{
+    struct counting_resource : std::pmr::memory_resource {
+        std::size_t allocations = 0;
+        void* do_allocate(std::size_t n, std::size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(n, alignment);
+        }
+        void do_deallocate(void* p, std::size_t n, std::size_t alignment) override { std::pmr::new_delete_resource()->deallocate(p, n, alignment); }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    } counting, other_counting;
+    HeterogeneousContainer_SparseSet3 container(&counting);
+    container.insert(A{ 1, 'a' }, C{ 2 }, counted{});
+    //↓ the new buffer and the four scratch tables
+    const auto allocations = counting.allocations;
+    container.reallocate(0);
+    EXPECT_EQ(counting.allocations, allocations + 5);
+    EXPECT_EQ(container.get<C>().v, 2);
+    //↓ tables are copied into the resource of the target, the buffer goes along with its resource
+    HeterogeneousContainer_SparseSet3 target(&other_counting);
+    target = std::move(container);
+    EXPECT_EQ(target.get<A>().x, 1);
+    EXPECT_EQ(target.get<C>().v, 2);
+    EXPECT_EQ(counted::alive, 1);
+}
+
+TEST(HeterogeneousContainer_SparseSet3, erase)
+{
+    HeterogeneousContainer_SparseSet3 container;
+    container.insert(A{ 1, 'a' }, C{ 2 }, counted{}, 4.0);
+    //↓ the last entry takes the place of the erased one
+    container.erase<A>();
+    EXPECT_FALSE(container.contains<A>());
+    EXPECT_EQ(container.tags.size(), 3);
+    EXPECT_EQ(container.get<double>(), 4.0);
+    container.erase<counted, double>();
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_FALSE((container.contains<counted>() || container.contains<double>()));
+    EXPECT_EQ(container.get<C>().v, 2);
+    //↓ erased bytes are dropped when the buffer grows
+    container.insert(std::array<char, 1000>{});
+    EXPECT_EQ(container.get<C>().v, 2);
+    EXPECT_LT(container.data.size(), 1000 + 2 * sizeof(C));
+    container.erase<C>();
+    container.insert(A{ 5, 'b' });
+    EXPECT_EQ(container.get<A>().x, 5);
+    EXPECT_FALSE(container.contains<C>());
+}
+
+TEST(HeterogeneousContainer_SparseSet3, clear)
+{
+    HeterogeneousContainer_SparseSet3 container;
+    container.insert(A{ 1, 'a' }, C{ 2 }, counted{});
+    const auto capacity = container.data.capacity();
+    container.clear();
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_FALSE(container.contains<A>() || container.contains<C>() || container.contains<counted>());
+    EXPECT_EQ(container.data.capacity(), capacity);
+    container.insert(C{ 3 });
+    EXPECT_EQ(container.get<C>().v, 3);
+    EXPECT_FALSE(container.contains<A>());
+}
+
+template<std::size_t... I>
+void check_local_slots(std::index_sequence<I...>)
+{
+    //↓ the flat sparse side grows with the largest id held, the local one with the number of types held
+    HeterogeneousContainer_SparseSet3 flat;
+    HeterogeneousContainer_SparseSet3_Local local;
+    flat.insert(A{ 1, 'a' });
+    local.insert(A{ 1, 'a' });
+    const type_id_t largest = std::max({ HeterogeneousContainer_SparseSet3::type_id<tagged<int(I)>>()... });
+    ((HeterogeneousContainer_SparseSet3::type_id<tagged<int(I)>>() == largest ? (flat.insert(tagged<int(I)>{}), local.insert(tagged<int(I)>{}), void()) : void()), ...);
+    EXPECT_GE(flat.sparse.size(), sizeof...(I));
+    EXPECT_EQ(local.sparse.capacity(), 8);
+    EXPECT_EQ(local.get<A>().x, 1);
+    local.clear();
+    local.insert(A{ 1, 'a' });
+    (local.insert(tagged<int(I)>{}), ...);
+    EXPECT_TRUE(((local.get<tagged<int(I)>>().v == int(I)) && ...));
+    local.erase<tagged<int(I)>...>();
+    EXPECT_TRUE(((!local.contains<tagged<int(I)>>()) && ...));
+    EXPECT_EQ(local.get<A>().x, 1);
+}
+
+TEST(HeterogeneousContainer_SparseSet3_Local, sparse_size)
+{
+    check_local_slots(std::make_index_sequence<300>{});
+}
+
+TEST(HeterogeneousContainer_SparseSet3_Local, insert_erase)
+{
+    HeterogeneousContainer_SparseSet3_Local container;
+    auto&& [a, c, d] = container.insert(A{ 1, 'a' }, C{ 2 }, 3.0);
+    EXPECT_EQ(std::uintptr_t(&c) % alignof(C), 0);
+    container.insert<counted>();
+    container.insert(std::string("short"));
+    EXPECT_TRUE((container.contains<A, C, double, counted, std::string>()));
+    container.erase<A>();
+    EXPECT_FALSE(container.contains<A>());
+    EXPECT_EQ(container.get<C>().v, 2);
+    EXPECT_EQ(container.get<std::string>(), "short");
+    container.insert_or_assign(C{ 4 });
+    EXPECT_EQ(container.get<C>().v, 4);
+    HeterogeneousContainer_SparseSet3_Local other(std::move(container));
+    EXPECT_FALSE(container.contains<C>());
+    EXPECT_EQ(other.get<double>(), 3.0);
+    other.clear();
+    EXPECT_EQ(counted::alive, 0);
+    other.insert(A{ 5, 'b' });
+    EXPECT_EQ(other.get<A>().x, 5);
+    EXPECT_FALSE(other.contains<C>());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,4 +1,9 @@
 ﻿#include <gtest/gtest.h>
+#include <vector>
+
+//↓ records the addresses the containers ask to prefetch
+static std::vector<const void*> prefetched;
+#define HECO_PREFETCH(address) prefetched.push_back(static_cast<const void*>(address))
 
 #undef NDEBUG
 #define protected public
@@ -11,8 +16,8 @@ using namespace heco;
 
 struct A
 {
-    int x;
-    char c;
+    int x = 0;
+    char c = 0;
     ~A() {};
 };
 static_assert(std::is_trivially_destructible_v < A > == false);
@@ -21,9 +26,9 @@ static_assert(sizeof(A) == 8);
 
 struct B
 {
-    double x;
-    int y[4];
-    A z;
+    double x = 0;
+    int y[4] = {};
+    A z{};
 };
 static_assert(std::is_trivially_destructible_v < B > == false);
 
@@ -240,6 +245,241 @@ TEST(HeterogeneousContainer_SparseSet, move_container)
     EXPECT_EQ(b.get<int>(), 42);
 }
 
+struct counted
+{
+    counted() { ++alive; }
+    counted(const counted&) { ++alive; }
+    ~counted() { --alive; }
+    static inline int alive = 0;
+};
+
+TEST(HeterogeneousContainer_SparseSet, memory_resource)
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    {
+        HeterogeneousContainer_SparseSet container(&arena);
+        EXPECT_EQ(container.resource(), &arena);
+        auto&& [a, c, d] = container.insert(A{ 1, 'a' }, C{ 2 }, 3.0);
+        EXPECT_TRUE(inside(&a) && inside(&c) && inside(&d));
+        EXPECT_EQ(std::uintptr_t(&c) % alignof(C), 0);
+        container.insert_or_assign(C{ 4 });
+        EXPECT_TRUE(inside(&container.get<C>()));
+        EXPECT_EQ(container.get<C>().v, 4);
+        container.insert<counted>();
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(HeterogeneousContainer_SparseSet, pooled)
+{
+    using pool = slab_pool_of<B>;
+    const B* first = nullptr;
+    {
+        HeterogeneousContainer_SparseSet container(pooled);
+        first = &container.insert(B{ 1.5 });
+        container.insert<counted>();
+        EXPECT_EQ(std::uintptr_t(first) % alignof(B), 0);
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+    const auto capacity = pool::instance().capacity();
+    const auto available = pool::instance().available();
+    //↓ slots go back to the pool and are handed out again, to any container
+    {
+        HeterogeneousContainer_SparseSet container(pooled);
+        EXPECT_EQ(&container.insert(B{ 2.5 }), first);
+        HeterogeneousContainer_SparseSet other(pooled);
+        auto& b = other.insert(B{ 3.5 });
+        EXPECT_EQ(pool::instance().available(), available - 2);
+        EXPECT_EQ(std::abs(reinterpret_cast<const std::byte*>(&b) - reinterpret_cast<const std::byte*>(first)) % pool::slot_size, 0);
+        container = std::move(other);
+        EXPECT_EQ(&container.get<B>(), &b);
+        EXPECT_EQ(container.get<B>().x, 3.5);
+    }
+    EXPECT_EQ(pool::instance().capacity(), capacity);
+    EXPECT_EQ(pool::instance().available(), available);
+}
+
+struct counting_resource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    void* do_allocate(std::size_t n, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(n, alignment);
+    }
+    void do_deallocate(void* p, std::size_t n, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+TEST(HeterogeneousContainer_SparseSet, bulk_insert)
+{
+    counting_resource counting;
+    {
+        HeterogeneousContainer_SparseSet container(&counting);
+        container.reserve(64);
+        container.insert<int>();
+        //↓ one allocation for the whole pack
+        const auto allocations = counting.allocations;
+        auto&& [a, c, k] = container.insert(A{ 1, 'a' }, C{ 2 }, counted{});
+        EXPECT_EQ(counting.allocations, allocations + 1);
+        using block = packed_block<A, C, counted>;
+        const auto [low, high] = std::minmax({ std::uintptr_t(&a), std::uintptr_t(&c), std::uintptr_t(&k) });
+        EXPECT_LT(high - low, block::size);
+        EXPECT_EQ(std::uintptr_t(&c) % alignof(C), 0);
+        EXPECT_EQ(container.get<A>().x, 1);
+        EXPECT_EQ(container.get<C>().v, 2);
+        EXPECT_EQ(counted::alive, 1);
+        //↓ objects stay in place when the container moves
+        HeterogeneousContainer_SparseSet other{ std::move(container) };
+        EXPECT_EQ(&other.get<C>(), &c);
+    }
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_EQ(counting.allocations, counting.deallocations);
+}
+
+template<int I>
+struct tagged { int value = I; };
+
+template<typename Container, int... I>
+void insert_tagged(Container& container, std::integer_sequence<int, I...>) { (container.template insert<tagged<I>>(), ...); }
+
+TEST(HeterogeneousContainer_SparseSet, wide_index)
+{
+    using Wide = BasicHeterogeneousContainer_SparseSet1<std::uint16_t>;
+    Wide container;
+    insert_tagged(container, std::make_integer_sequence<int, 300>{});
+    EXPECT_EQ(container.data.size(), 300);
+    EXPECT_EQ(container.get<tagged<0>>().value, 0);
+    EXPECT_EQ(container.get<tagged<255>>().value, 255);
+    EXPECT_EQ(container.get<tagged<299>>().value, 299);
+    //↓ only the page holding the id in use is allocated
+    Wide single;
+    single.insert(tagged<299>{});
+    EXPECT_EQ(std::count_if(single.sparse.begin(), single.sparse.end(), [](const auto* page) { return page != nullptr; }), 1);
+    EXPECT_TRUE(single.contains<tagged<299>>());
+    EXPECT_FALSE(single.contains<tagged<0>>());
+    EXPECT_FALSE(single.contains<tagged<298>>());
+}
+
+TEST(HeterogeneousContainer_SparseSet, erase)
+{
+    HeterogeneousContainer_SparseSet container;
+    container.insert(A{ 1, 'a' }, C{ 2 }, counted{}, 4.0);
+    auto* c = &container.get<C>();
+    //↓ the last object takes the place of the erased one, objects themselves do not move
+    container.erase<A>();
+    EXPECT_FALSE(container.contains<A>());
+    EXPECT_EQ(container.data.size(), 3);
+    EXPECT_EQ(&container.get<C>(), c);
+    EXPECT_EQ(container.get<double>(), 4.0);
+    container.erase<counted, double>();
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_FALSE((container.contains<counted>() || container.contains<double>()));
+    EXPECT_EQ(container.get<C>().v, 2);
+    //↓ erase the last one
+    container.erase<C>();
+    EXPECT_TRUE(container.data.empty());
+    container.insert(A{ 5, 'b' });
+    EXPECT_EQ(container.get<A>().x, 5);
+    EXPECT_FALSE(container.contains<C>());
+}
+
+TEST(HeterogeneousContainer_SparseSet, clear)
+{
+    HeterogeneousContainer_SparseSet container;
+    container.insert(A{ 1, 'a' }, C{ 2 }, counted{});
+    const auto capacity = container.data.capacity();
+    container.clear();
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_FALSE(container.contains<A>() || container.contains<C>() || container.contains<counted>());
+    EXPECT_EQ(container.data.capacity(), capacity);
+    container.insert(C{ 3 });
+    EXPECT_EQ(container.get<C>().v, 3);
+    EXPECT_FALSE(container.contains<A>());
+}
+
+TEST(HeterogeneousContainer_SparseSet2, erase)
+{
+    HeterogeneousContainer_SparseSet2 container;
+    container.insert(A{ 1, 'a' }, C{ 2 }, counted{}, 4.0);
+    auto* c = &container.get<C>();
+    //↓ the last object takes the place of the erased one, objects themselves do not move
+    container.erase<A>();
+    EXPECT_FALSE(container.contains<A>());
+    EXPECT_EQ(container.data.size(), 3);
+    EXPECT_EQ(&container.get<C>(), c);
+    EXPECT_EQ(container.get<double>(), 4.0);
+    container.erase<counted, double>();
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_FALSE((container.contains<counted>() || container.contains<double>()));
+    EXPECT_EQ(container.get<C>().v, 2);
+    //↓ erase the last one
+    container.erase<C>();
+    EXPECT_TRUE(container.data.empty());
+    container.insert(A{ 5, 'b' });
+    EXPECT_EQ(container.get<A>().x, 5);
+    EXPECT_FALSE(container.contains<C>());
+}
+
+TEST(HeterogeneousContainer_SparseSet2, clear)
+{
+    HeterogeneousContainer_SparseSet2 container;
+    container.insert(A{ 1, 'a' }, C{ 2 }, counted{});
+    const auto capacity = container.data.capacity();
+    container.clear();
+    EXPECT_EQ(counted::alive, 0);
+    EXPECT_FALSE(container.contains<A>() || container.contains<C>() || container.contains<counted>());
+    EXPECT_EQ(container.data.capacity(), capacity);
+    container.insert(C{ 3 });
+    EXPECT_EQ(container.get<C>().v, 3);
+    EXPECT_FALSE(container.contains<A>());
+}
+
+TEST(HeterogeneousContainer_SparseSet, prefetch)
+{
+    HeterogeneousContainer_SparseSet c;
+    c.insert(A{ 1, 'a' }, C{ 2 });
+    prefetched.clear();
+    c.prefetch<C, B, A>();
+    EXPECT_EQ(prefetched, (std::vector<const void*>{ &c.get<C>(), &c.get<A>() }));
+}
+
+TEST(HeterogeneousContainer_SparseSet, pages)
+{
+    counting_resource counting, other_counting;
+    {
+        using Wide = BasicHeterogeneousContainer_SparseSet1<std::uint16_t>;
+        Wide container(&counting);
+        insert_tagged(container, std::make_integer_sequence<int, 300>{});
+        //↓ pages are allocated from the resource of the container and kept by clear
+        const auto allocations = counting.allocations;
+        container.clear();
+        container.insert(tagged<299>{});
+        EXPECT_EQ(counting.allocations, allocations + 1);
+        //↓ moving between resources copies the pages, each one going back to the resource it came from
+        Wide other(&other_counting);
+        other.insert(tagged<1>{});
+        other = std::move(container);
+        EXPECT_EQ(other.get<tagged<299>>().value, 299);
+        EXPECT_FALSE(other.contains<tagged<1>>());
+        EXPECT_EQ(other.sparse.size(), 3);
+        EXPECT_EQ(std::count(other.sparse.begin(), other.sparse.end(), nullptr), 0);
+        Wide same(&other_counting);
+        same = std::move(other);
+        EXPECT_EQ(same.get<tagged<299>>().value, 299);
+    }
+    EXPECT_EQ(counting.allocations, counting.deallocations);
+    EXPECT_EQ(other_counting.allocations, other_counting.deallocations);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
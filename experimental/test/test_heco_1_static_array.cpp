@@ -0,0 +1,215 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_1_static_array.h>
+#undef protected
+#undef private
+
+using namespace heco;
+
+struct A
+{
+    int x;
+    char c;
+    ~A() {};
+};
+static_assert(std::is_trivially_destructible_v < A > == false);
+static_assert(alignof(A) == 4);
+static_assert(sizeof(A) == 8);
+
+struct B
+{
+    double x;
+    int y[4];
+    A z;
+};
+static_assert(std::is_trivially_destructible_v < B > == false);
+
+struct alignas(8) C { int v; };
+static_assert(alignof(C) == 8);
+static_assert(sizeof(C) == 8);
+
+struct D {};
+static_assert(std::is_empty_v<D>);
+
+TEST(HeterogeneousArray_Static, layout)
+{
+    using Container = HeterogeneousArray_Static<char, A, C, double, B>;
+    static_assert(Container::alignment == alignof(B));
+    static_assert(Container::offset_of<char>() == Container::layout.offsets[0]);
+    //↓ same packing as the runtime bulk allocation of HeterogeneousArray
+    HeterogeneousArray reference;
+    auto offsets = reference.reserve<char, A, C, double, B>();
+    constexpr auto static_offsets = Container::offset_of<char, A, C, double, B>();
+    for (size_t i = 0; i < static_offsets.size(); ++i)
+        EXPECT_EQ(static_offsets[i], offsets[i]);
+    EXPECT_EQ(Container::layout.size, reference.data.size());
+    static_assert(sizeof(Container::data) == Container::layout.size);
+}
+
+TEST(HeterogeneousArray_Static, insert)
+{
+    double X00 = 5.63454f;
+    int X01 = 218762532;
+
+    HeterogeneousArray_Static<double, int, float, char> container;
+    EXPECT_EQ(container.insert(X00), X00);
+    EXPECT_EQ(container.insert(X01), X01);
+    EXPECT_EQ(container.insert<float>(), 0);
+    EXPECT_EQ(container.insert<char>(), 0);
+    ASSERT_DEATH(container.insert(X01), "");
+}
+
+TEST(HeterogeneousArray_Static, insert_all)
+{
+    HeterogeneousArray_Static<char, double, bool, int, D> container;
+    auto&& [c, d, b] = container.insert(char{ 'a' }, double{ 1 }, bool{ true });
+    EXPECT_EQ(c, 'a');
+    EXPECT_EQ(d, 1);
+    EXPECT_EQ(b, true);
+    auto& i = container.insert(int{ 5 });
+    EXPECT_EQ(i, 5);
+    container.insert(D{});
+    EXPECT_EQ(container.contains<D>(), true);
+}
+
+TEST(HeterogeneousArray_Static, insert_or_assign)
+{
+    HeterogeneousArray_Static<char, double> container;
+    {
+        auto&& c = container.insert(char{ 'a' });
+        EXPECT_EQ(c, 'a');
+    }
+    {
+        auto&& c = container.insert_or_assign<char>('b');
+        EXPECT_EQ(c, 'b');
+    }
+    {
+        auto&& d = container.insert_or_assign<double>(3.14);
+        EXPECT_EQ(d, 3.14);
+    }
+    {
+        auto&& d = container.insert_or_assign<double>(42.);
+        EXPECT_EQ(d, 42.);
+        EXPECT_EQ(container.get<double>(), 42.);
+    }
+}
+
+TEST(HeterogeneousArray_Static, get)
+{
+    double X00 = 5.63454;
+    int X01 = 218762532;
+
+    HeterogeneousArray_Static<int, double> container;
+    container.insert(X00);
+    container.insert(X01);
+    auto&& v = container.get<double>();
+    EXPECT_EQ(v, X00);
+    EXPECT_EQ(container.get<int>(), X01);
+    auto&& [vd, vi] = container.get<double, int>();
+    static_assert(std::is_same_v<decltype(vd), double&>);
+    static_assert(std::is_same_v<decltype(vi), int&>);
+    EXPECT_EQ(vd, X00);
+    EXPECT_EQ(vi, X01);
+    EXPECT_EQ(&container.get<double>(), reinterpret_cast<double*>(container.data + container.offset_of<double>()[0]));
+}
+
+TEST(HeterogeneousArray_Static, const_get)
+{
+    double X00 = 5.63454;
+    int X01 = 218762532;
+
+    HeterogeneousArray_Static<int, double> hc;
+    hc.insert(X00);
+    hc.insert(X01);
+    const auto& container = hc;
+    EXPECT_EQ(container.get<const double>(), X00);
+    auto&& [vd, vi] = container.get<double, const int>();
+    static_assert(std::is_same_v<decltype(vd), double&>);
+    static_assert(std::is_same_v<decltype(vi), const int&>);
+    EXPECT_EQ(vd, X00);
+    EXPECT_EQ(vi, X01);
+}
+
+TEST(HeterogeneousArray_Static, contains)
+{
+    HeterogeneousArray_Static<double, A, B, int> container;
+    container.insert(5.63454);
+    container.insert(A{});
+    EXPECT_EQ(container.contains<double>(), true);
+    EXPECT_EQ(container.contains<int>(), false);
+    EXPECT_EQ(container.contains<A>(), true);
+    EXPECT_EQ(container.contains<B>(), false);
+    EXPECT_EQ(container.contains<float>(), false);
+    EXPECT_EQ((container.contains<A, double>()), true);
+    EXPECT_EQ((container.contains<A, B>()), false);
+    EXPECT_EQ(container.contains(type_id<A>()), true);
+    EXPECT_EQ(container.contains(type_id<int>()), false);
+    EXPECT_EQ(container.has<float>(), nullptr);
+    EXPECT_EQ(container.has<int>(), nullptr);
+    EXPECT_EQ(container.has<A>(), &container.get<A>());
+}
+
+struct counted {
+    counted() { ++alive; }
+    counted(const counted& other) : value(other.value) { ++alive; }
+    counted(counted&& other) : value(other.value) { ++alive; }
+    counted& operator=(const counted&) = default;
+    counted& operator=(counted&&) = default;
+    ~counted() { --alive; }
+    static inline int alive = 0;
+    int value = 0;
+};
+
+TEST(HeterogeneousArray_Static, non_trivially_destructible)
+{
+    {
+        HeterogeneousArray_Static<A, float, B, counted> container;
+        container.insert<counted>();
+        EXPECT_EQ(counted::alive, 1);
+        container.insert(A{});
+        container.insert(1.f);
+        container.insert<B>();
+        container.destruct<A, counted>();
+        EXPECT_EQ(counted::alive, 0);
+        EXPECT_EQ(container.contains<A>(), false);
+        container.assign(A{});
+        container.assign<counted>();
+        container.insert_or_assign<counted>();
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(HeterogeneousArray_Static, move_container)
+{
+    using vec = std::vector<int>;
+    using Container = HeterogeneousArray_Static<vec, int, counted>;
+    Container a;
+    a.insert(vec{ 5,25 });
+    a.insert(42);
+    a.insert<counted>().value = 7;
+    Container b{ std::move(a) };
+    //↓ is move valid
+    EXPECT_EQ(b.get<vec>()[0], 5);
+    EXPECT_EQ(b.get<vec>()[1], 25);
+    EXPECT_EQ(b.get<int>(), 42);
+    EXPECT_EQ(b.get<counted>().value, 7);
+    EXPECT_EQ(counted::alive, 1);
+    //↓ is original container reset
+    EXPECT_EQ((a.contains<vec>() || a.contains<int>() || a.contains<counted>()), false);
+    //↓ are containers really dissociated
+    a.insert_or_assign(56);
+    EXPECT_EQ(b.get<int>(), 42);
+    b = std::move(a);
+    EXPECT_EQ(b.get<int>(), 56);
+    EXPECT_EQ(b.contains<vec>(), false);
+    EXPECT_EQ(counted::alive, 0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,184 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_1_map_array.h>
+#include <heco_1_map_stable.h>
+#include <heco_frozen.h>
+#undef protected
+#undef private
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace heco;
+
+struct A { int i = 0; };
+struct B { double d = 0; };
+struct C { std::string s; };
+struct E {};
+
+template<int I>
+struct tagged { int value = I; };
+
+struct counted {
+    static inline int alive = 0;
+    int value = 0;
+    counted() { ++alive; }
+    counted(const counted&) { ++alive; }
+    counted(counted&&) { ++alive; }
+    ~counted() { --alive; }
+};
+
+//Every type held has a slot of its own
+template<typename F>
+void expect_perfect(const F& frozen)
+{
+    std::size_t n = 0;
+    for (const auto& s : frozen.table)
+        if (s.id != F::npos) {
+            EXPECT_EQ(&frozen.at(s.id), &s);
+            ++n;
+        }
+    EXPECT_EQ(n, frozen.size());
+}
+
+TEST(Frozen, HeterogeneousContainer)
+{
+    HeterogeneousContainer hc;
+    auto&& [a, b] = hc.insert(A{ 1 }, B{ 2. });
+    hc.insert(C{ "three" });
+    A* before = &a;
+    const Frozen<HeterogeneousContainer> frozen = std::move(hc).freeze();
+    EXPECT_TRUE(hc.data.empty());
+    EXPECT_EQ(frozen.size(), 3);
+    //↓ 3 types fit in 4 slots
+    EXPECT_EQ(frozen.capacity(), 4);
+    expect_perfect(frozen);
+    EXPECT_TRUE((frozen.contains<A, B, C>()));
+    EXPECT_FALSE((frozen.contains<A, E>()));
+    EXPECT_FALSE(frozen.has<E>());
+    //↓ objects did not move
+    EXPECT_EQ(&frozen.get<A>(), before);
+    auto&& [fb, fc] = frozen.get<B, C>();
+    EXPECT_EQ(fb.d, 2.);
+    EXPECT_EQ(fc.s, "three");
+    static_assert(std::is_same_v<decltype(frozen.get<A>()), const A&>);
+}
+
+TEST(Frozen, HeterogeneousArray)
+{
+    HeterogeneousArray ha;
+    ha.insert(A{ 1 }, B{ 2. }, C{ "three" });
+    ha.insert(E{});
+    ha.erase<B>();
+    auto frozen = std::move(ha).freeze();
+    EXPECT_EQ(frozen.size(), 3);
+    expect_perfect(frozen);
+    EXPECT_TRUE((frozen.contains<A, C, E>()));
+    EXPECT_FALSE(frozen.contains<B>());
+    EXPECT_TRUE(frozen.has<E>());
+    EXPECT_EQ(frozen.has<B>(), nullptr);
+    EXPECT_EQ(frozen.get<A>().i, 1);
+    EXPECT_EQ(frozen.get<C>().s, "three");
+    //↓ compacted: the hole of B is gone
+    EXPECT_TRUE(frozen.source.holes.empty());
+}
+
+TEST(Frozen, HeterogeneousArray_Small)
+{
+    HeterogeneousArray_Small<64> ha;
+    ha.insert(A{ 1 }, C{ "inline" });
+    auto frozen = std::move(ha).freeze();
+    auto moved = std::move(frozen);
+    EXPECT_EQ(moved.size(), 2);
+    //↓ objects moved with the inline buffer, the table follows
+    EXPECT_GE((const std::byte*)&moved.get<C>(), (const std::byte*)&moved.source);
+    EXPECT_LT((const std::byte*)&moved.get<C>(), (const std::byte*)(&moved.source + 1));
+    EXPECT_EQ(moved.get<A>().i, 1);
+    EXPECT_EQ(moved.get<C>().s, "inline");
+}
+
+template<int... I>
+void insert_tagged(HeterogeneousContainer& hc, HeterogeneousArray& ha, std::integer_sequence<int, I...>)
+{
+    (hc.insert(tagged<I>{}), ...);
+    (ha.insert(tagged<I>{}), ...);
+}
+
+template<typename F, int... I>
+bool has_tagged(const F& frozen, std::integer_sequence<int, I...>)
+{
+    return ((frozen.template get<tagged<I>>().value == I) && ...);
+}
+
+TEST(Frozen, many_types)
+{
+    HeterogeneousContainer hc;
+    HeterogeneousArray ha;
+    insert_tagged(hc, ha, std::make_integer_sequence<int, 200>{});
+    auto fhc = std::move(hc).freeze();
+    auto fha = std::move(ha).freeze();
+    EXPECT_EQ(fhc.size(), 200);
+    EXPECT_EQ(fha.size(), 200);
+    expect_perfect(fhc);
+    expect_perfect(fha);
+    EXPECT_TRUE(has_tagged(fhc, std::make_integer_sequence<int, 200>{}));
+    EXPECT_TRUE(has_tagged(fha, std::make_integer_sequence<int, 200>{}));
+}
+
+TEST(Frozen, thaw_destroy)
+{
+    {
+        HeterogeneousContainer hc;
+        hc.insert(counted{}, A{ 1 });
+        auto frozen = std::move(hc).freeze();
+        EXPECT_EQ(counted::alive, 1);
+        HeterogeneousContainer back = std::move(frozen).thaw();
+        EXPECT_EQ(frozen.capacity(), 0);
+        back.insert(B{ 3. });
+        EXPECT_EQ(back.get<A>().i, 1);
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+    {
+        HeterogeneousArray ha;
+        ha.insert(counted{}, A{ 1 });
+        auto frozen = std::move(ha).freeze();
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(Frozen, empty)
+{
+    auto frozen = HeterogeneousContainer{}.freeze();
+    EXPECT_EQ(frozen.size(), 0);
+    EXPECT_FALSE(frozen.contains<A>());
+    EXPECT_EQ(frozen.has<A>(), nullptr);
+}
+
+TEST(Frozen, concurrent)
+{
+    HeterogeneousArray ha;
+    ha.insert(A{ 1 }, B{ 2. }, C{ "three" });
+    const auto frozen = std::move(ha).freeze();
+    std::vector<std::thread> threads;
+    std::vector<long> sums(8);
+    for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&, t] {
+            for (int k = 0; k < 10000; ++k)
+                sums[t] += frozen.get<A>().i + long(frozen.get<B>().d) + long(frozen.get<C>().s.size());
+        });
+    for (auto& thread : threads)
+        thread.join();
+    for (long sum : sums)
+        EXPECT_EQ(sum, 80000);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
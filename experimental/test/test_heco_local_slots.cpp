@@ -0,0 +1,111 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_local_slots.h>
+#undef protected
+#undef private
+
+#include <random>
+#include <unordered_map>
+
+using namespace heco;
+
+TEST(local_slots, insert_find)
+{
+    local_slots<> slots;
+    EXPECT_EQ(slots.find(0), slots.npos);
+    EXPECT_EQ(slots.capacity(), 0);
+    slots.insert(100000, 0);
+    slots.insert(3, 1);
+    slots.insert(7, 2);
+    EXPECT_EQ(slots.find(100000), 0);
+    EXPECT_EQ(slots.find(3), 1);
+    EXPECT_EQ(slots.find(7), 2);
+    EXPECT_EQ(slots.find(4), slots.npos);
+    EXPECT_EQ(slots.size(), 3);
+    //↓ sized by the number of types, not by the largest id
+    EXPECT_EQ(slots.capacity(), 8);
+    slots.assign(3, 5);
+    EXPECT_EQ(slots.find(3), 5);
+}
+
+TEST(local_slots, growth)
+{
+    local_slots<std::uint16_t> slots;
+    for (type_id_t id = 0; id < 1000; ++id)
+        slots.insert(id * 37, std::uint16_t(id));
+    EXPECT_EQ(slots.size(), 1000);
+    EXPECT_EQ(slots.capacity(), 2048);
+    for (type_id_t id = 0; id < 1000; ++id)
+        EXPECT_EQ(slots.find(id * 37), id);
+}
+
+TEST(local_slots, erase)
+{
+    //↓ compare against std::unordered_map under random insertions and erasures, which exercises the back shift
+    std::mt19937 rng(42);
+    local_slots<std::uint16_t> slots;
+    std::unordered_map<type_id_t, std::uint16_t> reference;
+    for (int step = 0; step < 20000; ++step) {
+        const type_id_t id = rng() % 200;
+        if (reference.count(id)) {
+            slots.erase(id);
+            reference.erase(id);
+        }
+        else {
+            const std::uint16_t slot = std::uint16_t(rng() % 1000);
+            slots.insert(id, slot);
+            reference.emplace(id, slot);
+        }
+        ASSERT_EQ(slots.size(), reference.size());
+    }
+    for (type_id_t id = 0; id < 200; ++id) {
+        const auto it = reference.find(id);
+        EXPECT_EQ(slots.find(id), it != reference.end() ? it->second : slots.npos);
+    }
+}
+
+TEST(local_slots, clear)
+{
+    local_slots<> slots;
+    slots.insert(1, 0);
+    slots.insert(2, 1);
+    const auto capacity = slots.capacity();
+    slots.clear();
+    EXPECT_EQ(slots.size(), 0);
+    EXPECT_EQ(slots.capacity(), capacity);
+    EXPECT_EQ(slots.find(1), slots.npos);
+    slots.insert(2, 4);
+    EXPECT_EQ(slots.find(2), 4);
+}
+
+TEST(local_slots, move)
+{
+    local_slots<> a;
+    a.insert(1, 0);
+    local_slots<> b(std::move(a));
+    EXPECT_EQ(b.find(1), 0);
+    EXPECT_EQ(a.find(1), a.npos);
+    a.insert(1, 3);
+    EXPECT_EQ(b.find(1), 0);
+    b = std::move(a);
+    EXPECT_EQ(b.find(1), 3);
+}
+
+TEST(local_slots, memory_resource)
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    local_slots<> slots(&arena);
+    for (type_id_t id = 0; id < 20; ++id)
+        slots.insert(id, std::uint16_t(id));
+    EXPECT_EQ(slots.find(19), 19);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
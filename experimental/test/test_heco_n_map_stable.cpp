@@ -19,6 +19,24 @@ TEST(HeterogeneousContainer_n, insert_and_get)
     EXPECT_EQ(c.vector<int>().back(), 5);
 }
 
+TEST(HeterogeneousContainer_n, memory_resource)
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    HeterogeneousContainer_n c(&arena);
+    c.insert(1.5, 2.6);
+    c.insert(std::vector<int>{1, 2, 3});
+    for (int i = 0; i < 100; ++i)
+        c.vector<int>().push_back(i);
+    EXPECT_TRUE(inside(&c.vector<double>()));
+    EXPECT_TRUE(inside(c.vector<double>().data()));
+    EXPECT_TRUE(inside(c.vector<int>().data()));
+    EXPECT_EQ(c.vector<int>(2), 3);
+    EXPECT_EQ(c.vector<int>().back(), 99);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
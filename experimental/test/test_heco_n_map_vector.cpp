@@ -0,0 +1,52 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_n_map_vector.h>
+#undef protected
+#undef private
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace heco;
+
+TEST(HeterogeneousContainer_n, insert_and_get)
+{
+    HeterogeneousContainer_n c;
+    c.insert(1.5, 2.6, 24.2);
+    c.insert(std::vector<int>{1, 2, 3}, std::vector<int>{5});
+    c.vector<double>().push_back(3.14);
+    EXPECT_EQ(c.vector<double>(3), 3.14);
+    EXPECT_EQ(c.vector<int>().size(), 4);
+    EXPECT_EQ(c.vector<int>(3), 5);
+    //↓ a type already held is not inserted again
+    EXPECT_FALSE(c.insert(7));
+    EXPECT_EQ(c.vector<int>().size(), 4);
+}
+
+TEST(HeterogeneousContainer_n, memory_resource)
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    HeterogeneousContainer_n c(&arena);
+    c.insert(std::string("long enough not to fit in the small buffer"));
+    c.insert(std::vector<int>{1, 2, 3});
+    for (int i = 0; i < 100; ++i)
+        c.vector<int>().push_back(i);
+    EXPECT_EQ(c.vector<int>().resource(), &arena);
+    EXPECT_TRUE(inside(c.vector<int>().begin()));
+    EXPECT_TRUE(inside(c.vector<std::string>().begin()));
+    EXPECT_EQ(c.vector<int>(2), 3);
+    EXPECT_EQ(c.vector<int>(102), 99);
+    EXPECT_EQ(c.vector<std::string>(0), "long enough not to fit in the small buffer");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,183 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_1_map_array.h>
+#include <heco_1_map_stable.h>
+#include <heco_reclaim_queue.h>
+#undef protected
+#undef private
+
+#include <atomic>
+#include <chrono>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace heco;
+
+struct A { int i = 0; };
+struct B { double d = 0; };
+
+struct counted {
+    static inline std::atomic<int> alive = 0;
+    std::unordered_map<int, std::string> heavy{ { 1, "one" } };
+    counted() { ++alive; }
+    counted(const counted& o) : heavy(o.heavy) { ++alive; }
+    counted(counted&& o) : heavy(std::move(o.heavy)) { ++alive; }
+    ~counted() { --alive; }
+};
+
+TEST(reclaim_queue, drain)
+{
+    reclaim_queue queue;
+    std::vector<int> order;
+    struct marker {
+        std::vector<int>* order;
+        int i;
+        marker(std::vector<int>* o, int i) : order(o), i(i) {}
+        marker(marker&& m) : order(std::exchange(m.order, nullptr)), i(m.i) {}
+        ~marker() { if (order) order->push_back(i); }
+    };
+    for (int i = 0; i < 5; ++i)
+        queue.retire(marker{ &order, i });
+    EXPECT_EQ(queue.size(), 5);
+    EXPECT_TRUE(order.empty());
+    //↓ bounded batches, first retired first destroyed
+    EXPECT_EQ(queue.drain(2), 2);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1 }));
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.drain(), 3);
+    EXPECT_EQ(order, (std::vector<int>{ 0, 1, 2, 3, 4 }));
+    EXPECT_EQ(queue.drain(), 0);
+    queue.retire(marker{ &order, 5 });
+    EXPECT_EQ(queue.drain(1), 1);
+    EXPECT_EQ(order.back(), 5);
+}
+
+TEST(reclaim_queue, HeterogeneousContainer)
+{
+    reclaim_queue queue;
+    {
+        HeterogeneousContainer hc(deferred, queue);
+        hc.insert(counted{}, A{ 1 });
+        EXPECT_EQ(counted::alive, 1);
+    }
+    //↓ destruction waits for the queue
+    EXPECT_EQ(counted::alive, 1);
+    EXPECT_EQ(queue.size(), 1);
+    queue.drain();
+    EXPECT_EQ(counted::alive, 0);
+    {
+        HeterogeneousContainer hc(deferred, queue);
+        hc.insert(counted{});
+        //↓ the mode follows the objects
+        HeterogeneousContainer moved(std::move(hc));
+        EXPECT_EQ(moved.reclaim, &queue);
+        //↓ the objects replaced by an assignment are deferred too
+        moved = HeterogeneousContainer{};
+        EXPECT_EQ(queue.size(), 1);
+        EXPECT_EQ(counted::alive, 1);
+    }
+    //↓ empty containers queue nothing
+    EXPECT_EQ(queue.size(), 1);
+    queue.drain();
+    EXPECT_EQ(counted::alive, 0);
+}
+
+template<typename Array>
+void test_array()
+{
+    reclaim_queue queue;
+    {
+        Array ha(deferred, queue);
+        ha.insert(counted{}, A{ 1 }, B{ 2. });
+        Array moved(std::move(ha));
+        EXPECT_EQ(moved.reclaim, &queue);
+        EXPECT_EQ(moved.template get<A>().i, 1);
+    }
+    EXPECT_EQ(counted::alive, 1);
+    EXPECT_EQ(queue.size(), 1);
+    queue.drain();
+    EXPECT_EQ(counted::alive, 0);
+    {
+        Array ha(deferred, queue);
+        ha.insert(counted{});
+        auto frozen = std::move(ha).freeze();
+    }
+    EXPECT_EQ(counted::alive, 1);
+    queue.drain();
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(reclaim_queue, HeterogeneousArray)
+{
+    test_array<HeterogeneousArray>();
+    test_array<HeterogeneousArray_Segmented>();
+}
+
+TEST(reclaim_queue, destructor)
+{
+    {
+        reclaim_queue queue;
+        HeterogeneousContainer hc(deferred, queue);
+        hc.insert(counted{});
+        hc = HeterogeneousContainer{};
+        EXPECT_EQ(counted::alive, 1);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(reclaim_queue, background)
+{
+    reclaim_queue queue;
+    queue.start();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&] {
+            for (int k = 0; k < 1000; ++k) {
+                HeterogeneousArray ha(deferred, queue);
+                ha.insert(counted{}, A{ k });
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+    while (queue.size() > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    queue.stop();
+    EXPECT_EQ(counted::alive, 0);
+    //↓ stopped: retired containers wait for drain()
+    {
+        HeterogeneousArray ha(deferred, queue);
+        ha.insert(counted{});
+    }
+    EXPECT_EQ(queue.size(), 1);
+    queue.start();
+    queue.start();
+    while (queue.size() > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    //↓ joins the thread, which may still be destroying the last batch
+    queue.stop();
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(reclaim_queue, unsynchronized_resource)
+{
+    //↓ draining on the calling thread gives memory back to any resource
+    std::pmr::unsynchronized_pool_resource pool;
+    reclaim_queue queue;
+    {
+        HeterogeneousArray ha(deferred, queue, &pool);
+        ha.insert(counted{});
+    }
+    queue.drain();
+    EXPECT_EQ(counted::alive, 0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
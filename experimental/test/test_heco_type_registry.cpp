@@ -0,0 +1,122 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_type_registry.h>
+#include <heco_1_map_array.h>
+#include <heco_1_map_stable.h>
+#undef protected
+#undef private
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace heco;
+
+struct A
+{
+    int x;
+    char c;
+    ~A() {};
+};
+static_assert(std::is_trivially_destructible_v < A > == false);
+static_assert(alignof(A) == 4);
+static_assert(sizeof(A) == 8);
+
+struct B
+{
+    double x;
+    int y[4];
+    A z;
+};
+static_assert(std::is_trivially_destructible_v < B > == false);
+
+struct alignas(8) C { int v; };
+static_assert(alignof(C) == 8);
+static_assert(sizeof(C) == 8);
+
+struct D;
+
+extern "C" type_registry* plugin_registry();
+extern "C" type_id_t plugin_id_of_D();
+extern "C" type_id_t plugin_id_of_B();
+extern "C" type_hash_t plugin_stable_id_of_B();
+
+TEST(type_registry, type_name)
+{
+    static_assert(type_name<A>() == "A");
+    static_assert(type_name<int>() == "int");
+    static_assert(type_name<std::pair<int, C>>() == "std::pair<int, C>");
+    static_assert(type_name<int[4]>() == "int [4]");
+}
+
+TEST(type_registry, stable_type_id)
+{
+    //↓ usable at compile time, e.g. to precompute tables
+    constexpr type_hash_t table[] = { stable_type_id<A>, stable_type_id<B>, stable_type_id<C> };
+    static_assert(table[0] != table[1] && table[1] != table[2] && table[0] != table[2]);
+    static_assert(stable_type_id<A> == hash("A"));
+    EXPECT_EQ(stable_type_id<B>, plugin_stable_id_of_B());
+}
+
+TEST(type_registry, dense_type_id)
+{
+    type_registry& registry = type_registry::instance();
+    //↓ ids are handed out on first use, dense within a family and each family counts from 0
+    const type_id_t a = dense_type_id<A>(), b = dense_type_id<B>();
+    const std::size_t n = registry.size(stable_type_id<void>);
+    EXPECT_LT(a, n);
+    EXPECT_LT(b, n);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(registry.name(stable_type_id<void>, a), "A");
+    EXPECT_EQ(type_id<const A&>(), a);
+    const type_id_t in_family = dense_type_id<A, HeterogeneousContainer>();
+    EXPECT_LT(in_family, registry.size(stable_type_id<HeterogeneousContainer>));
+    //↓ asking again gives the same id
+    EXPECT_EQ(registry.id(stable_type_id<void>, stable_type_id<A>, type_name<A>()), dense_type_id<A>());
+    //↓ another type claiming the stable id of A is rejected in every build
+    EXPECT_THROW(registry.id(stable_type_id<void>, stable_type_id<A>, "not A"), std::logic_error);
+}
+
+TEST(type_registry, shared_object)
+{
+    //↓ a single registry in the process, even though the plugin hides its symbols
+    EXPECT_EQ(plugin_registry(), &type_registry::instance());
+    EXPECT_EQ(plugin_id_of_B(), dense_type_id<B>());
+    EXPECT_EQ(plugin_id_of_D(), dense_type_id<D>());
+    EXPECT_EQ(type_registry::instance().name(stable_type_id<void>, plugin_id_of_D()), "D");
+}
+
+TEST(type_registry, concurrent)
+{
+    type_registry& registry = type_registry::instance();
+    const type_hash_t family = hash("concurrent");
+    constexpr int n_threads = 8, n_types = 1000;
+    std::vector<std::vector<type_id_t>> ids(n_threads, std::vector<type_id_t>(n_types));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < n_types; ++i) {
+                const int k = (i * 7 + t * 131) % n_types;
+                const std::string name = "T" + std::to_string(k);
+                ids[t][k] = registry.id(family, hash(name), name);
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+    //↓ every thread sees the same id for a type and ids are 0..n-1
+    for (int t = 1; t < n_threads; ++t)
+        EXPECT_EQ(ids[t], ids[0]);
+    std::vector<type_id_t> sorted = ids[0];
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < n_types; ++i)
+        EXPECT_EQ(sorted[i], type_id_t(i));
+    EXPECT_EQ(registry.size(family), n_types);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
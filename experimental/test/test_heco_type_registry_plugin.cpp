@@ -0,0 +1,11 @@
+﻿//Shared object used by test_heco_type_registry, built with hidden visibility to check that ids still match
+#include <heco_type_registry.h>
+
+struct B;
+struct D;
+
+extern "C" __attribute__((visibility("default"))) heco::type_registry* plugin_registry() { return &heco::type_registry::instance(); }
+//↓ D is first seen here
+extern "C" __attribute__((visibility("default"))) heco::type_id_t plugin_id_of_D() { return heco::dense_type_id<D>(); }
+extern "C" __attribute__((visibility("default"))) heco::type_id_t plugin_id_of_B() { return heco::dense_type_id<B>(); }
+extern "C" __attribute__((visibility("default"))) heco::type_hash_t plugin_stable_id_of_B() { return heco::stable_type_id<B>; }
@@ -0,0 +1,207 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <heco_type_set.h>
+#include <heco_1_map_array.h>
+#include <heco_1_hybrid_array.h>
+#include <heco_1_shared_array.h>
+#include <heco_1_map_stable.h>
+#include <heco_1_sparseset_stable.h>
+#include <heco_1_sparseset_array.h>
+#include <heco_n_map_stable.h>
+#undef protected
+#undef private
+
+using namespace heco;
+
+struct A
+{
+    int x;
+    char c;
+    ~A() {};
+};
+static_assert(std::is_trivially_destructible_v < A > == false);
+static_assert(alignof(A) == 4);
+static_assert(sizeof(A) == 8);
+
+struct B
+{
+    double x;
+    int y[4];
+    A z;
+};
+static_assert(std::is_trivially_destructible_v < B > == false);
+
+struct alignas(8) C { int v; };
+static_assert(alignof(C) == 8);
+static_assert(sizeof(C) == 8);
+
+template<int I>
+struct tagged { int v = I; };
+
+TEST(type_set, bits)
+{
+    type_set set;
+    static_assert(alignof(type_set) == 32);
+    EXPECT_FALSE(set.test(0));
+    set.set(0);
+    set.set(63);
+    set.set(64);
+    set.set(255);
+    EXPECT_TRUE(set.test(0) && set.test(63) && set.test(64) && set.test(255));
+    EXPECT_FALSE(set.test(1) || set.test(65));
+    set.reset(63);
+    EXPECT_FALSE(set.test(63));
+    //↓ ids without bit are ignored
+    type_set copy = set;
+    copy.set(256);
+    EXPECT_EQ(copy, set);
+    set.clear();
+    EXPECT_EQ(set, type_set{});
+}
+
+TEST(type_set, includes)
+{
+    const type_mask mask = type_mask::of(3, 70, 200);
+    EXPECT_TRUE(mask.exact);
+    type_set set;
+    EXPECT_FALSE(set.includes(mask.bits));
+    EXPECT_TRUE(set.includes(type_set{}));
+    set.set(3);
+    set.set(70);
+    EXPECT_FALSE(set.includes(mask.bits));
+    set.set(200);
+    set.set(5);
+    EXPECT_TRUE(set.includes(mask.bits));
+    //↓ a single missing word fails the whole test
+    set.reset(70);
+    EXPECT_FALSE(set.includes(mask.bits));
+    //↓ masks reaching beyond the set are not exact
+    EXPECT_FALSE(type_mask::of(3, 256).exact);
+    EXPECT_EQ((set | type_mask::of(70).bits).includes(mask.bits), true);
+}
+
+template<typename Container>
+void check_presence()
+{
+    Container container;
+    EXPECT_TRUE(container.template contains<>());
+    EXPECT_FALSE((container.template contains<A>()));
+    container.insert(A{ 1, 'a' }, C{ 2 });
+    container.insert(3.0);
+    EXPECT_TRUE((container.template contains<A, C, double>()));
+    EXPECT_TRUE((container.template contains<double, A>()));
+    EXPECT_FALSE((container.template contains<A, B>()));
+    EXPECT_TRUE(container.presence().includes(Container::template mask<A, C>().bits));
+    EXPECT_FALSE(container.presence().includes(Container::template mask<B>().bits));
+    Container other(std::move(container));
+    EXPECT_TRUE((other.template contains<A, C, double>()));
+    EXPECT_FALSE((container.template contains<A>()));
+}
+
+TEST(type_set, contains)
+{
+    check_presence<HeterogeneousArray>();
+    check_presence<HeterogeneousArray_Segmented>();
+    check_presence<HeterogeneousArray_Small<64>>();
+    check_presence<HeterogeneousArray_Shared>();
+    check_presence<HeterogeneousArray_Hybrid<C, int>>();
+    check_presence<HeterogeneousContainer>();
+    check_presence<HeterogeneousContainer_SparseSet>();
+    check_presence<HeterogeneousContainer_SparseSet2>();
+    check_presence<HeterogeneousContainer_SparseSet3>();
+}
+
+template<typename Container>
+void check_removal()
+{
+    Container container;
+    container.insert(A{ 1, 'a' }, C{ 2 }, 3.0);
+    container.template erase<C>();
+    EXPECT_FALSE((container.template contains<A, C>()));
+    EXPECT_TRUE((container.template contains<A, double>()));
+    container.clear();
+    EXPECT_FALSE((container.template contains<A>()));
+    EXPECT_EQ(container.presence(), type_set{});
+}
+
+TEST(type_set, erase_clear)
+{
+    check_removal<HeterogeneousArray>();
+    check_removal<HeterogeneousContainer_SparseSet>();
+    check_removal<HeterogeneousContainer_SparseSet2>();
+    check_removal<HeterogeneousContainer_SparseSet3>();
+    HeterogeneousArray container;
+    container.insert(A{ 1, 'a' }, C{ 2 });
+    //↓ the slot is kept but the object is gone
+    container.destruct<C>();
+    EXPECT_FALSE(container.contains<C>());
+    EXPECT_TRUE(container.is_allocated<C>());
+    container.assign(C{ 3 });
+    EXPECT_TRUE((container.contains<A, C>()));
+}
+
+TEST(type_set, vectors)
+{
+    HeterogeneousContainer_n container;
+    container.insert(1, 2, 3);
+    container.insert(std::vector<double>{ 1., 2. });
+    EXPECT_TRUE((container.contains<int, double>()));
+    EXPECT_FALSE((container.contains<int, char>()));
+}
+
+//↓ a family of its own, as ids are handed out before main in no particular order
+using Wide = BasicHeterogeneousContainer_SparseSet1<std::uint16_t>;
+
+template<std::size_t... I>
+void check_beyond_capacity(std::index_sequence<I...>)
+{
+    //↓ more types than bits, some masks cannot be exact
+    EXPECT_GT(((Wide::mask<tagged<int(I)>>().exact ? 0 : 1) + ...), 0);
+    Wide container;
+    container.insert(A{ 1, 'a' });
+    EXPECT_TRUE(((!container.contains<A, tagged<int(I)>>()) && ...));
+    (container.insert(tagged<int(I)>{}), ...);
+    EXPECT_TRUE((container.contains<A, tagged<int(I)>...>()));
+    EXPECT_TRUE(((container.contains<tagged<int(I)>>()) && ...));
+    container.erase<tagged<int(I)>...>();
+    EXPECT_TRUE(((!container.contains<tagged<int(I)>>()) && ...));
+    std::vector<Wide> all(3);
+    (all[1].insert(tagged<int(I)>{}), ...);
+    all[2].insert(tagged<0>{});
+    std::vector<Wide*> selected;
+    filter<tagged<int(I)>...>(all.begin(), all.end(), std::back_inserter(selected));
+    EXPECT_EQ(selected, std::vector<Wide*>{ &all[1] });
+}
+
+TEST(type_set, beyond_capacity)
+{
+    check_beyond_capacity(std::make_index_sequence<type_set::capacity + 44>{});
+}
+
+TEST(type_set, filter)
+{
+    std::vector<HeterogeneousContainer_SparseSet> all(5);
+    all[0].insert(A{ 1, 'a' });
+    all[1].insert(A{ 2, 'b' }, C{ 1 });
+    all[2].insert(C{ 2 });
+    all[3].insert(C{ 3 }, 1.0, A{ 3, 'c' });
+    std::vector<HeterogeneousContainer_SparseSet*> selected;
+    filter<A, C>(all.begin(), all.end(), std::back_inserter(selected));
+    ASSERT_EQ(selected.size(), 2);
+    EXPECT_EQ(selected[0], &all[1]);
+    EXPECT_EQ(selected[1], &all[3]);
+    selected.clear();
+    //↓ const containers and no type at all
+    const auto& view = all;
+    std::vector<const HeterogeneousContainer_SparseSet*> every;
+    filter<>(view.begin(), view.end(), std::back_inserter(every));
+    EXPECT_EQ(every.size(), 5);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,66 @@
+﻿#include <gtest/gtest.h>
+
+#undef NDEBUG
+#define protected public
+#define private   public
+#include <vectr.h>
+#undef protected
+#undef private
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace heco;
+
+TEST(vecter, push_and_copy)
+{
+    vecter v = vecter::create<std::string>();
+    auto& strings = v.vector<std::string>();
+    strings.push_back(std::string("one"));
+    strings.emplace_back("two");
+    for (int i = 0; i < 100; ++i)
+        strings.emplace_back(std::to_string(i));
+    EXPECT_EQ(strings.size(), 102);
+    EXPECT_EQ(*strings.rbegin(), "99");
+    vecter copy = v;
+    EXPECT_EQ(copy.vector<std::string>(1), "two");
+    vecter moved = std::move(v);
+    EXPECT_EQ(moved.vector<std::string>().back(), "99");
+    copy = moved;
+    EXPECT_EQ(copy.vector<std::string>().size(), 102);
+    //↓ clear keeps the memory, reset gives it back
+    auto& copied = copy.vector<std::string>();
+    const auto capacity = copied.capacity();
+    copied.clear();
+    EXPECT_EQ(copied.capacity(), capacity);
+    copied.reset();
+    EXPECT_EQ(copied.capacity(), 0);
+}
+
+TEST(vecter, memory_resource)
+{
+    //↓ anything not served by the local buffer would throw
+    alignas(64) std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    auto inside = [&](const void* p) { return p >= buffer && p < buffer + sizeof(buffer); };
+    vecter v = vecter::create<int>(&arena);
+    auto& ints = v.vector<int>();
+    ints.resize(10);
+    for (int i = 0; i < 100; ++i)
+        ints.push_back(i);
+    ints.shrink_to_fit();
+    EXPECT_EQ(ints.get_allocator().resource(), &arena);
+    EXPECT_TRUE(inside(ints.data()));
+    EXPECT_EQ(ints[10], 0);
+    EXPECT_EQ(ints.back(), 99);
+    //↓ copies allocate from the resource of the source
+    vecter copy = v;
+    EXPECT_EQ(copy.resource(), &arena);
+    EXPECT_TRUE(inside(copy.vector<int>().data()));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
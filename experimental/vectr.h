@@ -1,6 +1,12 @@
+#pragma once
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <type_traits>
+#include <utility>
 #include <cassert>
 #include <algorithm>
 
@@ -20,8 +26,8 @@ namespace heco
         std::size_t alignment;
         void (*destroy)(void* begin, void* end);
         void (*copy)(void* begin, void* end, void* to);
-        void*(*clone)(void* begin, void* end);
-        void (*deallocate)(void* begin, void* end);
+        void*(*clone)(std::pmr::memory_resource* resource, void* begin, void* end);
+        void (*deallocate)(std::pmr::memory_resource* resource, void* begin, void* cap);
 
         template<typename T>
         Vtable(Itself<T>) :
@@ -51,16 +57,18 @@ namespace heco
                 std::copy((const T*)sta, (const T*)end, (T*)other);
             }
             template<typename T>
-            static void* clone(void* sta, void* end) {
+            static void* clone(std::pmr::memory_resource* resource, void* sta, void* end) {
                 std::size_t n = (const T*)end - (const T*)sta;
-                using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
-                T* new_start = reinterpret_cast<T*>(new Storage[n]);
-                std::copy((const T*)sta, (const T*)end, new_start);
+                if (n == 0)
+                    return nullptr;
+                T* new_start = static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+                std::uninitialized_copy((const T*)sta, (const T*)end, new_start);
                 return new_start;
             };
             template<typename T>
-            static void deallocate(void* begin, void* end) {
-                std::allocator<T>().deallocate((T*)begin, (T*)end - (T*)begin);
+            static void deallocate(std::pmr::memory_resource* resource, void* begin, void* cap) {
+                if (begin != nullptr)
+                    resource->deallocate(begin, ((T*)cap - (T*)begin) * sizeof(T), alignof(T));
             }
         };
     };
@@ -69,21 +77,26 @@ namespace heco
     {
     protected:
         const Vtable* vtable = &Vtable::of<std::byte>;
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource();//< elements are allocated from it
         void* _sta = nullptr;
         void* _end = nullptr;
         void* _cap = nullptr;
     public:
         vecter() = default;
-        vecter(const Vtable* v) : vtable(v) {};
+        vecter(const Vtable* v, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : vtable(v), memory(resource) {};
+        //The elements and their resource are taken over
         vecter(vecter&& other) noexcept :
             vtable(other.vtable),
+            memory(other.memory),
             _sta(std::exchange(other._sta, nullptr)),
             _end(std::exchange(other._end, nullptr)),
             _cap(std::exchange(other._cap, nullptr))
         {}
+        //The copy allocates from the resource of other
         vecter(const vecter& other) :
             vtable(other.vtable),
-            _sta(other.vtable->clone(other._sta, other._end)),
+            memory(other.memory),
+            _sta(other.vtable->clone(other.memory, other._sta, other._end)),
             _end(begin() + other.size()),
             _cap(begin() + other.size())
         {}
@@ -91,8 +104,9 @@ namespace heco
             if (&other != this)
             {
                 vtable->destroy(_sta, _end);
-                vtable->deallocate(_sta, _end);
+                vtable->deallocate(memory, _sta, _cap);
                 vtable = other.vtable;
+                memory = other.memory;
                 _sta = std::exchange(other._sta, nullptr);
                 _end = std::exchange(other._end, nullptr);
                 _cap = std::exchange(other._cap, nullptr);
@@ -103,9 +117,9 @@ namespace heco
             if (&other != this)
             {
                 vtable->destroy(_sta, _end);
-                vtable->deallocate(_sta, _end);
+                vtable->deallocate(memory, _sta, _cap);
                 vtable = other.vtable;
-                _sta = other.vtable->clone(other._sta, other._sta);
+                _sta = other.vtable->clone(memory, other._sta, other._end);
                 _end = begin() + other.size();
                 _cap = begin() + other.size();
             }
@@ -115,7 +129,7 @@ namespace heco
             if (vtable != nullptr && _sta != nullptr)
                 vtable->destroy(_sta, _end);
             if (_sta != nullptr)
-                vtable->deallocate(_sta, _end);
+                vtable->deallocate(memory, _sta, _cap);
         }
 
         constexpr std::byte* cap() noexcept { return static_cast<std::byte*>(_cap); }
@@ -127,29 +141,30 @@ namespace heco
         std::size_t size() const noexcept { return end() - begin(); }
         std::size_t capacity() const noexcept { return cap() - begin(); }
 
+        std::pmr::memory_resource* resource() const noexcept { return memory; }
         std::size_t id() const noexcept { return vtable->id; }
         std::size_t size_value() const noexcept { return vtable->size; }
         std::size_t alignment_value() const noexcept { return vtable->alignment; }
 
         template<typename T>
-        static vecter_impl<T> create() { return vecter_impl<T>(); }
+        static vecter_impl<T> create(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) { return vecter_impl<T>(resource); }
 
         template<typename T>
         auto& vector() {
             assert(typeid_v<T>() == id());
-            return *static_cast<vectr::vecter_impl<T>*>(this);
+            return *static_cast<vecter_impl<T>*>(this);
         }
         template<typename T>
         auto& vector(std::size_t i) {
             assert(typeid_v<T>() == id());
-            return (*static_cast<vectr::vecter_impl<T>*>(this))[i];
+            return (*static_cast<vecter_impl<T>*>(this))[i];
         }
     };
 
     template<typename T = std::byte>
     struct vecter_impl final : vecter
     {
-        using Allocator = std::allocator<T>;
+        using Allocator = std::pmr::polymorphic_allocator<T>;
         // types
         using value_type = T;
         using allocator_type = Allocator;
@@ -170,10 +185,10 @@ namespace heco
         constexpr const_iterator         begin() const noexcept { return static_cast<T*>(_sta); }
         constexpr iterator               end() noexcept { return static_cast<T*>(_end); }
         constexpr const_iterator         end() const noexcept { return static_cast<T*>(_end); }
-        constexpr reverse_iterator       rbegin() noexcept { return end() - 1; }
-        constexpr const_reverse_iterator rbegin() const noexcept { return end() - 1; }
-        constexpr reverse_iterator       rend() noexcept { return begin() - 1; }
-        constexpr const_reverse_iterator rend() const noexcept { return begin() - 1; }
+        constexpr reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+        constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        constexpr reverse_iterator       rend() noexcept { return reverse_iterator(begin()); }
+        constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
         constexpr const_iterator         cbegin() const noexcept { return begin(); }
         constexpr const_iterator         cend() const noexcept { return end(); }
         constexpr const_reverse_iterator crbegin() const noexcept { return rbegin(); }
@@ -190,8 +205,8 @@ namespace heco
                     i = 1ULL << x++;
                 return i;
             } ();
-            auto new_capacity = std::min(i, 256ULL);
-            new_capacity = new_capacity == 256 ? std::max(256ULL,std::size_t(1.5 * sz)) : new_capacity;
+            auto new_capacity = std::min(i, std::size_t(256));
+            new_capacity = new_capacity == 256 ? std::max(std::size_t(256), std::size_t(1.5 * sz)) : new_capacity;
             reserve(new_capacity);
             _end = std::uninitialized_value_construct_n(end(), sz - size());
         }
@@ -202,19 +217,18 @@ namespace heco
                     i = 1ULL << x++;
                 return i;
             } ();
-            auto new_capacity = std::min(i, 256ULL);
-            new_capacity = new_capacity == 256 ? std::max(256ULL, std::size_t(1.5 * sz)) : new_capacity;
+            auto new_capacity = std::min(i, std::size_t(256));
+            new_capacity = new_capacity == 256 ? std::max(std::size_t(256), std::size_t(1.5 * sz)) : new_capacity;
             reserve(new_capacity);
             _end = std::uninitialized_fill_n(end(), sz - size(), c);
         }
         constexpr void reserve(size_type n) {
             if (n > capacity()) {
                 const size_type s = size();
-                using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
-                T* new_start = reinterpret_cast<T*>(new Storage[n]);
+                T* new_start = allocate(n);
                 std::uninitialized_move(begin(), end(), new_start);
                 vtable->destroy(_sta, _end);
-                vtable->deallocate(_sta, _end);
+                vtable->deallocate(memory, _sta, _cap);
                 _sta = new_start;
                 _end = new_start + s;
                 _cap = new_start + n;
@@ -223,11 +237,10 @@ namespace heco
         constexpr void shrink_to_fit() {
             const size_type s = size();
             if (capacity() > size()) {
-                using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
-                T* new_start = static_cast<T*>(new Storage[s]);
+                T* new_start = s > 0 ? allocate(s) : nullptr;
                 std::uninitialized_move(begin(), end(), new_start);
                 vtable->destroy(_sta, _end);
-                vtable->deallocate(_sta, _end);
+                vtable->deallocate(memory, _sta, _cap);
                 _sta = new_start;
                 _end = new_start + s;
                 _cap = _end;
@@ -248,7 +261,7 @@ namespace heco
         // [vecter_impl.modifiers], modifiers
         template<class... Args> constexpr reference emplace_back(Args&&... args)
         {
-            reserve(size() + 1);
+            grow();
             T* obj = nullptr;
             if constexpr (std::is_aggregate_v<T>)
                 obj = ::new (_end) T{ std::forward<Args>(args)... };
@@ -259,7 +272,7 @@ namespace heco
         }
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
         constexpr reference push_back(U&& x) {
-            reserve(size() + 1);
+            grow();
             T* obj = new(_end) T(std::forward<U>(x));
             _end = end() + 1;
             return *obj;
@@ -270,17 +283,30 @@ namespace heco
             _end = end() - 1;
             return T(std::move(*end()));
         }
+        //Destroy the elements, keeping the memory
         constexpr void clear() noexcept {
             std::destroy(begin(), end());
-            _cap = _end = _sta;
+            _end = _sta;
         }
+        //Destroy the elements and give the memory back to the resource
         constexpr void reset() noexcept {
             std::destroy(begin(), end());
-            vtable->deallocate(begin(), cap());
+            vtable->deallocate(memory, begin(), cap());
             _cap = _end = _sta = nullptr;
         }
 
+        allocator_type get_allocator() const noexcept { return allocator_type(memory); }
+
         // user-defined
-        vecter_impl() : vecter(&Vtable::of<T>) {}
+        //Elements are allocated from resource
+        explicit vecter_impl(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : vecter(&Vtable::of<T>, resource) {}
+
+    private:
+        //Double the capacity when full, rather than reserving one more element at a time
+        void grow() {
+            if (size() == capacity())
+                reserve(std::max(size_type(1), 2 * capacity()));
+        }
+        T* allocate(size_type n) { return static_cast<T*>(memory->allocate(n * sizeof(T), alignof(T))); }
     };
 }